@@ -11,6 +11,9 @@ Frontline positions are even, backline - odd.
 5 4    4 5
 --]]
 
+-- Result depends only on slots of the units, so it is computed once for each combination
+pureTargets = true
+
 function getTargets(attacker, selected, allies, targets, targetsAreAllies)
 	-- If targets are enemies and the attacker stands on the backline (position % 2 ~= 0)
 	if not targetsAreAllies and attacker.backline then
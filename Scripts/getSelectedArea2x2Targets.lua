@@ -11,6 +11,9 @@ Frontline positions are even, backline - odd.
 5 4    4 5
 --]]
 
+-- Result depends only on slots of the units, so it is computed once for each combination
+pureTargets = true
+
 function getTargets(attacker, selected, allies, targets, targetsAreAllies)
 	-- Get targets in 2x2 area including the selected (splash attack)
 	local result = {selected}
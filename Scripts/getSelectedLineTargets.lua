@@ -11,6 +11,9 @@ Frontline positions are even, backline - odd.
 5 4    4 5
 --]]
 
+-- Result depends only on slots of the units, so it is computed once for each combination
+pureTargets = true
+
 function getTargets(attacker, selected, allies, targets, targetsAreAllies)
 	-- Get all targets from the selected line (wide-cleave attack)
 	local result = {selected}
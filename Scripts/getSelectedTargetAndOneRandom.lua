@@ -11,9 +11,14 @@ Frontline positions are even, backline - odd.
 5 4    4 5
 --]]
 
-function getTargets(attacker, selected, allies, targets, targetsAreAllies)
+function getTargets(attacker, selected, allies, targets, targetsAreAllies, item, battle, isMarking)
     local result = {selected}
 
+    -- Marking runs on the client, its random pick would not match the one made by the server
+    if isMarking then
+        return result
+    end
+
     local others = {}
     for i = 1, #targets do
         local target = targets[i]
@@ -24,8 +29,7 @@ function getTargets(attacker, selected, allies, targets, targetsAreAllies)
 
     if #others > 0 then
         -- Pick any other target randomly
-        math.randomseed(os.time())
-        local other = others[math.random(#others)]
+        local other = others[rng:int(1, #others)]
         table.insert(result, other)
     end
 
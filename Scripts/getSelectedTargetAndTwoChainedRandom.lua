@@ -11,11 +11,15 @@ Frontline positions are even, backline - odd.
 5 4    4 5
 --]]
 
-function getTargets(attacker, selected, allies, targets, targetsAreAllies)
+function getTargets(attacker, selected, allies, targets, targetsAreAllies, item, battle, isMarking)
 	local result = {selected}
 
+	-- Marking runs on the client, its random picks would not match the ones made by the server
+	if isMarking then
+		return result
+	end
+
 	-- Get 2 random targets closest to each other (chain attack)
-	math.randomseed(os.time())
 	local current = selected
 	for n = 1, 2 do
 		-- Get closest targets (excluding already picked)
@@ -42,7 +46,7 @@ function getTargets(attacker, selected, allies, targets, targetsAreAllies)
 		end
 
 		-- Pick a random closest target
-		current = closest[math.random(#closest)]
+		current = closest[rng:int(1, #closest)]
 		table.insert(result, current)
 	end
 
@@ -122,6 +122,27 @@ settings = {
 			-- Lobby client port (0 means auto-assign by OS)
 			port = 0,
 		},
+
+		-- Subscribe to online users and chat updates pushed by lobby server instead of polling.
+		-- Enable only if lobby server supports it
+		pushUpdates = false,
+
+		-- Record sent and received network packets to netCapture-*.bin files in the game folder.
+		-- Login and account packets are recorded without their contents
+		captureTraffic = false,
+
+		-- Network faults to test multiplayer over a bad connection, all disabled by default.
+		-- Applied to packets this game receives, random choices are repeatable for the same seed
+		-- faults = {
+		-- 	-- Packet delay and its random variation in milliseconds
+		-- 	delay = 100,
+		-- 	jitter = 50,
+		-- 	-- Percent of packets lost by network, each loss delays the packet until it is resent
+		-- 	lossChance = 5,
+		-- 	-- Chance per 10000 packets to lose connection
+		-- 	disconnectChance = 0,
+		-- 	seed = 1,
+		-- },
 	},
 
 	unitEncyclopedia = {
@@ -0,0 +1,60 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BATTLEAIRECORDER_H
+#define BATTLEAIRECORDER_H
+
+#include "d2set.h"
+#include <string>
+
+namespace game {
+struct BattleMsgData;
+struct CMidgardID;
+struct PossibleTargets;
+
+enum class BattleAction : int;
+} // namespace game
+
+namespace hooks {
+
+/**
+ * Appends battle AI decision made by custom 'chooseAction' script to battleAi-*.bin file
+ * in the game folder, so recorded decisions can be replayed through the script and compared.
+ * File starts with "D2AI" magic and uint32 version. Each record is:
+ * [uint32 script path length][script path relative to scripts folder]
+ * [BattleMsgData][uint32 active unit id]
+ * [uint32 actions count][int32 action]...
+ * attack, item 1 and item 2 targets, each as
+ * [uint32 target group id][uint32 targets count][int32 position]...
+ * [int32 chosen action][uint32 target unit id][uint32 attacker unit id].
+ * Missing target group is recorded as empty id. All numbers are little-endian.
+ * Units are not recorded, replay needs the scenario where the battle took place.
+ */
+void recordBattleAiDecision(const std::string& scriptPath,
+                            const game::BattleMsgData* battleMsgData,
+                            const game::CMidgardID* unitId,
+                            const game::Set<game::BattleAction>* possibleActions,
+                            const game::PossibleTargets* possibleTargets,
+                            game::BattleAction battleAction,
+                            const game::CMidgardID* targetUnitId,
+                            const game::CMidgardID* attackerUnitId);
+
+} // namespace hooks
+
+#endif // BATTLEAIRECORDER_H
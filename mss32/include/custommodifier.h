@@ -23,6 +23,7 @@
 #include "attack.h"
 #include "currency.h"
 #include "idvector.h"
+#include "scriptprofiler.h"
 #include "scripts.h"
 #include "umunit.h"
 #include "unitview.h"
@@ -158,6 +159,7 @@ struct CCustomModifier
     {
         try {
             if (function) {
+                const ScriptProfilerScope profilerScope{"CustomModifier"};
                 if (!unit)
                     return prev;
                 const auto unitImpl = getPrev();
@@ -177,6 +179,7 @@ struct CCustomModifier
     {
         try {
             if (function) {
+                const ScriptProfilerScope profilerScope{"CustomModifier"};
                 if (!unit)
                     return prev;
                 const auto unitImpl = getPrev();
@@ -197,6 +200,7 @@ struct CCustomModifier
     {
         try {
             if (function) {
+                const ScriptProfilerScope profilerScope{"CustomModifier"};
                 if (!unit)
                     return prev;
                 const auto unitImpl = getPrev();
@@ -215,6 +219,7 @@ struct CCustomModifier
     {
         try {
             if (function) {
+                const ScriptProfilerScope profilerScope{"CustomModifier"};
                 return (*function)();
             }
         } catch (const std::exception& e) {
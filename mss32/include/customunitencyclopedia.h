@@ -26,6 +26,7 @@
 #include <optional>
 #include <sol/sol.hpp>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace game {
@@ -66,6 +67,14 @@ public:
                                      int lowerDamageLevel,
                                      int lowerInitiativeLevel) const;
 
+    /**
+     * Drops memoized texts.
+     * Texts are cached while encyclopedia is shown, so redraws caused by modifier key presses
+     * do not call scripts again. Cache keys include unit state, applied modifiers, modifier key
+     * state and function arguments, so changed units always get their texts recomputed.
+     */
+    void clearCache() const;
+
 protected:
     template <typename... Args>
     std::string getValue(std::optional<sol::function> function,
@@ -91,8 +100,30 @@ protected:
 private:
     const CustomUnitEncyclopediaFunctions& getFunctions() const;
 
+    std::string getCacheKey(const char* functionName,
+                            const game::CMidUnit* unit,
+                            const game::IUsUnit* unitImpl) const;
+
+    template <typename Getter>
+    std::string getCachedValue(std::string&& key, Getter&& getter) const
+    {
+        if (key.empty()) {
+            return getter();
+        }
+
+        auto it = textCache.find(key);
+        if (it != textCache.end()) {
+            return it->second;
+        }
+
+        auto value = getter();
+        textCache[std::move(key)] = value;
+        return value;
+    }
+
     mutable CustomUnitEncyclopediaFunctions* mainThreadFunctions;
     mutable CustomUnitEncyclopediaFunctions* workerThreadFunctions;
+    mutable std::unordered_map<std::string, std::string> textCache;
 };
 
 CustomUnitEncyclopedia& getCustomUnitEncyclopedia();
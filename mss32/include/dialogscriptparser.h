@@ -0,0 +1,114 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DIALOGSCRIPTPARSER_H
+#define DIALOGSCRIPTPARSER_H
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hooks {
+
+/**
+ * Standalone parser of interface script (.dlg) files.
+ * Does not depend on the game, so the same files the game reads with its own parser
+ * can be checked for errors and reported with their line and column.
+ */
+
+enum class DialogControlType
+{
+    Unknown,
+    Button,
+    ButtonSd,
+    Text,
+    Image,
+    Edit,
+    ListBox,
+    TextListBox,
+    Spin,
+    ToggleSd,
+    Radio,
+};
+
+struct DialogScriptArgument
+{
+    std::string value;
+    int column;
+    /** True if value was enclosed in double quotes, quotes are not part of the value. */
+    bool quoted;
+};
+
+struct DialogScriptControl
+{
+    DialogControlType type;
+    /** Keyword as written in the file. */
+    std::string typeName;
+    /** Control name followed by control specific arguments. */
+    std::vector<DialogScriptArgument> arguments;
+    int line;
+    int column;
+};
+
+struct DialogScriptDialog
+{
+    /** Dialog name followed by dialog arguments. */
+    std::vector<DialogScriptArgument> arguments;
+    std::vector<DialogScriptControl> controls;
+    int line;
+    int column;
+};
+
+struct DialogScriptError
+{
+    int line;
+    int column;
+    std::string message;
+};
+
+struct DialogScript
+{
+    std::vector<DialogScriptDialog> dialogs;
+    /** Syntax errors found by parser followed by errors found by validator. */
+    std::vector<DialogScriptError> errors;
+};
+
+/** Returns control type by its keyword, Unknown if keyword is not supported. */
+DialogControlType getDialogControlType(std::string_view keyword);
+
+/** Parses contents of interface script file. Syntax errors are stored in the result. */
+DialogScript parseDialogScript(std::string_view contents);
+
+/**
+ * Checks parsed dialogs for errors the game parser does not report clearly:
+ * wrong argument count, non-numeric coordinates, too long or duplicate names,
+ * references to missing controls.
+ */
+void validateDialogScript(DialogScript& script);
+
+/**
+ * Parses and validates interface script file.
+ * @returns false if file could not be read.
+ */
+bool loadDialogScript(const std::filesystem::path& path, DialogScript& script);
+
+} // namespace hooks
+
+#endif // DIALOGSCRIPTPARSER_H
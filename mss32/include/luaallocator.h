@@ -0,0 +1,109 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LUAALLOCATOR_H
+#define LUAALLOCATOR_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hooks {
+
+/**
+ * Memory allocator for a single Lua state.
+ * Small blocks are served from size-class pools that reuse freed blocks without going to the heap,
+ * which reduces heap churn from short-lived tables and strings created by scripts.
+ * Larger blocks are allocated from the heap directly.
+ * The allocator is not thread safe, same as the Lua state that uses it.
+ */
+class LuaAllocator
+{
+public:
+    /** @param[in] name state name to use in diagnostics. */
+    LuaAllocator(const char* name);
+    ~LuaAllocator();
+
+    LuaAllocator(const LuaAllocator&) = delete;
+    LuaAllocator& operator=(const LuaAllocator&) = delete;
+
+    /** lua_Alloc compatible function, expects LuaAllocator instance as user data. */
+    static void* allocate(void* userData, void* ptr, std::size_t oldSize, std::size_t newSize);
+
+    /** Sets maximum number of bytes the state can use, 0 means no limit. */
+    void setMemoryLimit(std::size_t value);
+
+    std::size_t getUsedMemory() const;
+    std::size_t getPeakMemory() const;
+
+    /** Writes memory usage, pool usage and top allocated object types to the log. */
+    void logStatistics() const;
+
+private:
+    // Blocks up to 256 bytes are pooled using 16 byte granularity
+    static constexpr std::size_t sizeClassGranularity{16};
+    static constexpr std::size_t sizeClassCount{16};
+    static constexpr std::size_t maxPooledSize{sizeClassGranularity * sizeClassCount};
+    static constexpr std::size_t chunkSize{64 * 1024};
+    // Lua object types from lua.h and lobject.h plus a slot for non-object allocations
+    static constexpr std::size_t allocationKindCount{12};
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    struct SizeClass
+    {
+        FreeBlock* freeBlocks{};
+        std::size_t liveBlocks{};
+    };
+
+    struct AllocationKindStats
+    {
+        std::uint64_t count{};
+        std::uint64_t bytes{};
+    };
+
+    static std::size_t getSizeClass(std::size_t size);
+
+    void* reallocate(void* ptr, std::size_t oldSize, std::size_t newSize);
+    void* allocateBlock(std::size_t size);
+    /** Keeps the existing block for its new smaller size when a new block is not available. */
+    void keepShrunkBlock(void* ptr, std::size_t oldSize, std::size_t newSize);
+    void freeBlock(void* ptr, std::size_t size);
+    void onLimitExceeded(std::size_t requestedSize);
+
+    std::string m_name;
+    std::size_t m_memoryLimit;
+    std::size_t m_usedMemory;
+    std::size_t m_peakMemory;
+    bool m_limitReported;
+    std::array<SizeClass, sizeClassCount> m_sizeClasses;
+    std::array<AllocationKindStats, allocationKindCount> m_allocationKinds;
+    std::vector<void*> m_chunks;
+    std::uint8_t* m_chunkPosition;
+    std::size_t m_chunkRemaining;
+};
+
+} // namespace hooks
+
+#endif // LUAALLOCATOR_H
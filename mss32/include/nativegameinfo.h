@@ -24,6 +24,8 @@
 
 namespace hooks {
 
+struct DbfTexts;
+
 class NativeGameInfo final : public rsg::GameInfo
 {
 public:
@@ -83,10 +85,9 @@ private:
     bool readLandmarksInfo();
     bool readRacesInfo();
 
-    bool readEditorInterfaceTexts(const std::filesystem::path& interfFolderPath);
+    bool readEditorInterfaceTexts(const DbfTexts& texts);
 
-    bool readCityNames(const std::filesystem::path& scenDataFolderPath);
-    bool readSiteTexts(const std::filesystem::path& scenDataFolderPath);
+    bool readCityNames(const DbfTexts& texts);
 
     rsg::UnitsInfo unitsInfo{};
     rsg::UnitInfoArray leaders{};
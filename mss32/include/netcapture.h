@@ -0,0 +1,69 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NETCAPTURE_H
+#define NETCAPTURE_H
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+namespace hooks {
+
+/**
+ * Records network packets to a file, so lobby and game traffic can be decoded and replayed later.
+ * File starts with "D2NC" magic, uint32 version and uint64 capture start time in milliseconds
+ * since Unix epoch. Each record is:
+ * [uint8 direction][uint32 milliseconds since start][uint64 peer guid][uint32 length][data].
+ * Data is the packet as SLikeNet delivers it, so the first byte is message id.
+ * Lobby2 packets contain login credentials, only their message id (and timestamp, if any)
+ * is recorded.
+ * All numbers are little-endian.
+ */
+class NetCapture
+{
+public:
+    enum class Direction : std::uint8_t
+    {
+        Sent,
+        Received,
+    };
+
+    static constexpr std::uint32_t version{1};
+
+    /** Creates capture file with unique name in the specified folder. */
+    NetCapture(const std::filesystem::path& folder);
+
+    bool isOpen() const;
+    void write(Direction direction,
+               std::uint64_t peerGuid,
+               const unsigned char* data,
+               std::uint32_t length);
+
+private:
+    std::ofstream m_stream;
+    std::chrono::steady_clock::time_point m_start;
+    std::mutex m_mutex;
+};
+
+} // namespace hooks
+
+#endif // NETCAPTURE_H
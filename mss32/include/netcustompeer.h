@@ -20,16 +20,40 @@
 #ifndef NETCUSTOMPEER_H
 #define NETCUSTOMPEER_H
 
+#include "netcapture.h"
+#include "usersettings.h"
 #include <RakPeer.h>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
 
 namespace hooks {
 
+class NetGameMessageCallback
+{
+public:
+    virtual ~NetGameMessageCallback() = default;
+    /**
+     * Called by whichever thread routes game messages, see CNetCustomPeer::RouteGameMessages.
+     * @returns true if the packet is consumed, false to leave it to the main thread.
+     */
+    virtual bool onGameMessageReceived(const SLNet::Packet* packet) = 0;
+};
+
 /**
  * Sends notification message to a window when there are network packets to receive.
  * Keeps notification flag to be reset outside by the receiver to avoid cluttering the window's
  * message queue.
+ * Injects faults configured in 'lobby.faults' user settings into received packets.
+ * Packets are delayed, but their order is kept since all messages are sent reliable ordered,
+ * so lost packets are simulated by the delay of their retransmission.
+ * Records sent and received packets if 'lobby.captureTraffic' user setting is enabled.
+ * Game messages are routed to players without waiting for the main thread, see RouteGameMessages.
  */
 class CNetCustomPeer : public SLNet::RakPeer
 {
@@ -40,14 +64,82 @@ public:
     bool IsPacketNotificationSent() const;
     void ResetPacketNotification();
 
+    void AddGameMessageCallback(NetGameMessageCallback* callback);
+    void RemoveGameMessageCallback(NetGameMessageCallback* callback);
+
+    /**
+     * Passes packets from the front of the return queue to game message callbacks until one is
+     * not consumed, so routed packets are never reordered with the ones left to the main thread.
+     * Called by the network thread and by players receiving messages in their own threads.
+     * Does nothing while the main thread receives packets or when faults are injected.
+     */
+    void RouteGameMessages();
+
+    /**
+     * Keeps game messages from being routed while the main thread processes packets.
+     * Does not wait if they are being routed right now, returns false then.
+     */
+    bool TryBeginReceive();
+    void EndReceive();
+
+    SLNet::Packet* Receive() override;
+
+    std::uint32_t Send(const char* data,
+                       const int length,
+                       PacketPriority priority,
+                       PacketReliability reliability,
+                       char orderingChannel,
+                       const SLNet::AddressOrGUID systemIdentifier,
+                       bool broadcast,
+                       std::uint32_t forceReceiptNumber = 0) override;
+
+    std::uint32_t Send(const SLNet::BitStream* bitStream,
+                       PacketPriority priority,
+                       PacketReliability reliability,
+                       char orderingChannel,
+                       const SLNet::AddressOrGUID systemIdentifier,
+                       bool broadcast,
+                       std::uint32_t forceReceiptNumber = 0) override;
+
 protected:
     static void UpdateThreadCallback(RakPeerInterface* peer, void* data);
 
     void SendPacketNotification();
 
 private:
+    using Clock = std::chrono::steady_clock;
+
+    struct DelayedPacket
+    {
+        SLNet::Packet* packet;
+        Clock::time_point dueTime;
+    };
+
+    SLNet::Packet* ReceiveWithFaults();
+    void RouteFrontGameMessages();
+    void CaptureSent(const SLNet::AddressOrGUID& systemIdentifier,
+                     bool broadcast,
+                     const unsigned char* data,
+                     std::uint32_t length);
+
+    bool InjectsFaults() const;
+    bool IsDelayedPacketDue() const;
+    void DelayPacket(SLNet::Packet* packet);
+    SLNet::Packet* CreateConnectionLostPacket(const SLNet::Packet* packet);
+
     std::uint32_t m_packetNotificationMessageId;
     std::atomic<bool> m_packetNotificationSent;
+    Lobby::Faults m_faults;
+    std::mt19937 m_faultsRandom;
+    /** Accessed only by the thread that receives packets. */
+    std::deque<DelayedPacket> m_delayedPackets;
+    /** Due time of the first delayed packet for the network thread to send notification. */
+    std::atomic<Clock::rep> m_nextDueTime;
+    std::unique_ptr<NetCapture> m_capture;
+    std::vector<NetGameMessageCallback*> m_gameMessageCallbacks;
+    std::mutex m_gameMessageCallbacksMutex;
+    /** Set while a thread takes packets from the return queue, so it can not be re-entered. */
+    std::atomic<bool> m_receiving;
 };
 
 } // namespace hooks
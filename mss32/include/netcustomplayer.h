@@ -21,11 +21,10 @@
 #define NETCUSTOMPLAYER_H
 
 #include "mqnetplayer.h"
+#include "netmessagequeue.h"
+#include "roommembership.h"
 #include <cstdint>
-#include <map>
 #include <memory>
-#include <mutex>
-#include <queue>
 #include <string>
 
 namespace game {
@@ -60,7 +59,7 @@ public:
     ~CNetCustomPlayer();
 
 protected:
-    using RemoteClients = std::map<SLNet::RakNetGUID, SLNet::RakString>;
+    using RemoteClients = RoomMembership::Members;
 
     static uint32_t getClientId(const SLNet::RakNetGUID& guid);
     static const game::NetMessageHeader* getMessageAndSender(const SLNet::Packet* packet,
@@ -106,16 +105,13 @@ protected:
     static int __fastcall method8(CNetCustomPlayer* thisptr, int /*%edx*/, int a2);
 
 private:
-    using NetMessagePtr = std::unique_ptr<unsigned char[]>;
-    using IdMessagePair = std::pair<std::uint32_t, NetMessagePtr>;
-
     CNetCustomSession* m_session;
     game::IMqNetSystem* m_system;
     game::IMqNetReception* m_reception;
     std::string m_name;
     std::uint32_t m_id;
-    std::queue<IdMessagePair> m_messages;
-    mutable std::mutex m_messagesMutex;
+    /** Filled by peer callbacks, drained by the thread that runs the player. */
+    NetMessageQueue m_messages;
     std::shared_ptr<spdlog::logger> m_logger;
 };
 
@@ -52,7 +52,9 @@ protected:
     static bool __fastcall isHost(CNetCustomPlayerClient* thisptr, int /*%edx*/);
 
 private:
-    class PeerCallback : public NetPeerCallback
+    class PeerCallback
+        : public NetPeerCallback
+        , public NetGameMessageCallback
     {
     public:
         PeerCallback(CNetCustomPlayerClient* player)
@@ -64,6 +66,8 @@ private:
                               SLNet::RakPeerInterface* peer,
                               const SLNet::Packet* packet) override;
 
+        bool onGameMessageReceived(const SLNet::Packet* packet) override;
+
     private:
         CNetCustomPlayerClient* m_player;
     };
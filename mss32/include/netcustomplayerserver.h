@@ -59,7 +59,9 @@ private:
     RemoteClients getRemoteClients() const;
     SLNet::RakNetGUID getRemoteClientGuid(std::uint32_t id) const;
 
-    class PeerCallback : public NetPeerCallback
+    class PeerCallback
+        : public NetPeerCallback
+        , public NetGameMessageCallback
     {
     public:
         PeerCallback(CNetCustomPlayerServer* player)
@@ -70,6 +72,8 @@ private:
                               SLNet::RakPeerInterface* peer,
                               const SLNet::Packet* packet) override;
 
+        bool onGameMessageReceived(const SLNet::Packet* packet) override;
+
     private:
         CNetCustomPlayerServer* m_player;
     };
@@ -95,7 +99,7 @@ private:
 
     PeerCallback m_peerCallback;
     RoomsCallback m_roomsCallback;
-    RemoteClients m_remoteClients;
+    RoomMembership m_remoteClients;
     mutable std::mutex m_remoteClientsMutex;
 };
 
@@ -21,6 +21,7 @@
 #define NETCUSTOMSERVICE_H
 
 #include "mqnetservice.h"
+#include "netcustompeer.h"
 #include "netmsg.h"
 #include "uievent.h"
 #include <Lobby2Client.h>
@@ -31,6 +32,7 @@
 #include <RoomsPlugin.h>
 #include <filesystem>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -51,10 +53,20 @@ enum ClientMessages
     ID_LOBBY_GET_CHAT_MESSAGES_RESPONSE,
     ID_GAME_MESSAGE_TO_HOST_SERVER,
     ID_GAME_MESSAGE_TO_HOST_CLIENT,
+    // Push-based lobby updates, see CNetCustomService::subscribeLobbyUpdates.
+    // [uint32 last known chat message id, 0 if none]
+    ID_LOBBY_SUBSCRIBE_REQUEST,
+    // No payload
+    ID_LOBBY_UNSUBSCRIBE_REQUEST,
+    // [uint32 sequence][uint32 count]{[RakNetGUID guid][RakString name]}
+    ID_LOBBY_ONLINE_USERS_SNAPSHOT,
+    // [uint32 sequence][bool joined][RakNetGUID guid][RakString name, only if joined]
+    ID_LOBBY_ONLINE_USERS_DELTA,
+    // [bool subscribe reply][uint32 count]{[uint32 id][RakString sender][RakString text]}
+    ID_LOBBY_CHAT_MESSAGES_UPDATE,
     ID_GAME_MESSAGE = game::netMessageNormalType & 0xff,
 };
 
-class CNetCustomPeer;
 class CNetCustomSession;
 
 class NetPeerCallback
@@ -88,6 +100,13 @@ public:
         SLNet::RakString text;
     };
 
+    struct ChatMessagesUpdate
+    {
+        std::vector<ChatMessage> messages;
+        /** True if messages are the whole chat history that replaces previously received one. */
+        bool history;
+    };
+
     // !!! Keep in sync with lobby server
     static constexpr std::uint32_t peerConnectionTimeout{30000};
     static constexpr std::uint32_t peerShutdownTimeout{100};
@@ -149,6 +168,28 @@ public:
     void queryChatMessages();
     std::vector<ChatMessage> readChatMessages(const SLNet::Packet* packet);
 
+    /**
+     * Asks lobby server to push online users and chat changes instead of being polled.
+     * Server replies with ID_LOBBY_ONLINE_USERS_SNAPSHOT and ID_LOBBY_CHAT_MESSAGES_UPDATE
+     * carrying chat history, then sends ID_LOBBY_ONLINE_USERS_DELTA when a user joins or leaves
+     * and ID_LOBBY_CHAT_MESSAGES_UPDATE with each new message instead of ID_LOBBY_CHAT_MESSAGE.
+     * Deltas and chat messages are numbered, so a missed one is detected and the service
+     * subscribes again with the last chat message id it has, to receive only the missed ones.
+     * Older servers ignore the request, use onlineUsersSynced to fall back to polling.
+     */
+    void subscribeLobbyUpdates();
+    void unsubscribeLobbyUpdates();
+
+    /** Returns true if online users are kept up to date by the lobby server. */
+    bool onlineUsersSynced() const;
+    /** Online users, updated before ID_LOBBY_ONLINE_USERS_SNAPSHOT/DELTA reach peer callbacks. */
+    const std::vector<UserInfo>& getOnlineUsers() const;
+
+    /** Returns true if chat messages are pushed by the lobby server. */
+    bool chatMessagesSynced() const;
+    /** New messages of the last ID_LOBBY_CHAT_MESSAGES_UPDATE, duplicates are skipped. */
+    const ChatMessagesUpdate& getChatMessagesUpdate() const;
+
     /** Tries to create and enter a new room. */
     bool createRoom(const char* gameName,
                     const char* scenarioName,
@@ -167,6 +208,12 @@ public:
     /** Tries to change number of public slots in current room. */
     bool changeRoomPublicSlots(unsigned int publicSlots);
 
+    /**
+     * Checks if the room is the one the user created or entered.
+     * Room notifications of other rooms should be ignored.
+     */
+    bool isCurrentRoom(SLNet::RoomID roomId) const;
+
     /**
      * The service is always first to receive peer notifications.
      * So other listeners will be dealing with already updated service state.
@@ -174,6 +221,16 @@ public:
     void addPeerCallback(NetPeerCallback* callback);
     void removePeerCallback(NetPeerCallback* callback);
 
+    /**
+     * Game message callbacks are called by the network thread or by players threads as soon as
+     * packets arrive. Peer callbacks receive the packets that are not consumed by them.
+     */
+    void addGameMessageCallback(NetGameMessageCallback* callback);
+    void removeGameMessageCallback(NetGameMessageCallback* callback);
+
+    /** Routes received game messages right in the calling thread. */
+    void routeGameMessages() const;
+
     /**
      * The service is always first to receive lobby notifications.
      * So other listeners will be dealing with already updated service state.
@@ -252,7 +309,10 @@ private:
     class RoomsCallback : public SLNet::RoomsCallback
     {
     public:
-        RoomsCallback() = default;
+        RoomsCallback(CNetCustomService* service)
+            : m_service(service)
+        { }
+
         ~RoomsCallback() override = default;
 
         void CreateRoom_Callback(const SLNet::SystemAddress& senderAddress,
@@ -277,6 +337,9 @@ private:
                                   SLNet::RoomsErrorCode resultCode,
                                   SLNet::RoomID roomId,
                                   SLNet::RoomDescriptor* roomDescriptor = nullptr) const;
+
+    private:
+        CNetCustomService* m_service;
     };
 
     static void __fastcall peerProcessEventCallback(const CNetCustomService* thisptr,
@@ -285,6 +348,24 @@ private:
                                                     long);
     std::vector<NetPeerCallback*> getPeerCallbacks() const;
 
+    struct LobbyUpdates
+    {
+        bool subscribed{};
+        bool resyncRequested{};
+        bool usersSynced{};
+        std::uint32_t usersSequence{};
+        std::vector<UserInfo> users;
+        bool chatSynced{};
+        std::uint32_t lastChatMessageId{};
+        ChatMessagesUpdate chatUpdate{};
+    };
+
+    void requestLobbyUpdates(std::uint32_t lastChatMessageId);
+    void resyncLobbyUpdates();
+    void readOnlineUsersSnapshot(const SLNet::Packet* packet);
+    void readOnlineUsersDelta(const SLNet::Packet* packet);
+    void readChatMessagesUpdate(const SLNet::Packet* packet);
+
     bool m_connected;
     PeerCallback m_peerCallback;
     CNetCustomSession* m_session;
@@ -297,6 +378,7 @@ private:
     /** Interacts with lobby server rooms. */
     SLNet::RoomsPlugin m_roomsClient;
     RoomsCallback m_roomsCallback;
+    std::optional<SLNet::RoomID> m_roomId;
     /** Connection with lobby server. */
     CNetCustomPeer* m_peer;
     game::UiEvent m_peerProcessEvent;
@@ -305,6 +387,7 @@ private:
     std::string m_gameFilesHash;
     std::string m_templateName;
     std::string m_templateHash;
+    LobbyUpdates m_lobbyUpdates;
 };
 
 assert_offset(CNetCustomService, vftable, 0);
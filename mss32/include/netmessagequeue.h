@@ -0,0 +1,95 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NETMESSAGEQUEUE_H
+#define NETMESSAGEQUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+namespace hooks {
+
+/**
+ * Queue of received network messages with any number of producers and a single consumer.
+ * Messages are copied into a fixed ring of slots that keep their buffers for reuse,
+ * so neither producers nor the consumer take a lock or allocate memory in the common case.
+ * When the consumer falls behind and the ring is full, messages go to a locked overflow queue
+ * until it is drained, so nothing is lost and messages of each producer stay in order.
+ */
+class NetMessageQueue
+{
+public:
+    NetMessageQueue();
+
+    void push(std::uint32_t idFrom, const unsigned char* data, std::size_t length);
+
+    /**
+     * Returns the oldest message without removing it, or nullptr if there are no messages.
+     * Consumer only.
+     */
+    const std::vector<unsigned char>* front(std::uint32_t* idFrom);
+    /** Removes the message returned by front. Consumer only. */
+    void pop();
+
+    /** Approximate number of messages, exact when called by the consumer. */
+    std::size_t size() const;
+    /** Number of messages that did not fit into the ring. */
+    std::uint32_t overflowCount() const;
+
+private:
+    static constexpr std::size_t capacity{256};
+    // Larger buffers are released after use, the ring should not hold big messages forever
+    static constexpr std::size_t maxReusedBufferSize{64 * 1024};
+
+    static_assert((capacity & (capacity - 1)) == 0, "Capacity must be a power of 2");
+
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence;
+        std::uint32_t idFrom;
+        std::vector<unsigned char> data;
+    };
+
+    struct OverflowMessage
+    {
+        std::uint32_t idFrom;
+        std::vector<unsigned char> data;
+    };
+
+    bool pushToRing(std::uint32_t idFrom, const unsigned char* data, std::size_t length);
+
+    std::array<Slot, capacity> m_slots;
+    alignas(64) std::atomic<std::size_t> m_enqueuePosition;
+    alignas(64) std::size_t m_dequeuePosition;
+    std::atomic<std::size_t> m_overflowSize;
+    std::atomic<std::uint32_t> m_overflowCount;
+    std::queue<OverflowMessage> m_overflow;
+    mutable std::mutex m_overflowMutex;
+    /** Tells pop where the message returned by front is. */
+    bool m_frontInOverflow;
+};
+
+} // namespace hooks
+
+#endif // NETMESSAGEQUEUE_H
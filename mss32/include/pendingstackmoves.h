@@ -0,0 +1,50 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PENDINGSTACKMOVES_H
+#define PENDINGSTACKMOVES_H
+
+namespace game {
+struct CMidgardID;
+struct CMqPoint;
+struct IMidgardObjectMap;
+} // namespace game
+
+namespace hooks {
+
+/**
+ * Remembers stack move sent to the server with CStackMoveMsg.
+ * Moves are numbered in the order they are sent, server confirms them in the same order
+ * with CCmdMoveStackEndMsg.
+ */
+void addPendingStackMove(const game::CMidgardID& stackId, const game::CMqPoint& endPosition);
+
+/**
+ * Confirms the oldest pending move, logs its round trip time and the position the stack
+ * actually ended at if server stopped it earlier (ambush, event, blocked tile).
+ * @returns true if there are no more pending moves and CMidObjectLock can be released.
+ */
+bool confirmPendingStackMove(const game::IMidgardObjectMap* objectMap);
+
+/** Forgets pending moves of the previous game session. */
+void clearPendingStackMoves();
+
+} // namespace hooks
+
+#endif // PENDINGSTACKMOVES_H
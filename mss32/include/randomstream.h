@@ -0,0 +1,79 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RANDOMSTREAM_H
+#define RANDOMSTREAM_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace sol {
+class state;
+}
+
+namespace hooks {
+
+/**
+ * Counter-based random generator (Philox4x32-10) with a key derived from the common seed
+ * and the stream name. The same seed and name produce the same sequence on every machine,
+ * independently from other streams and from the game generator.
+ */
+class RandomStream
+{
+public:
+    explicit RandomStream(const std::string& name);
+
+    /** Returns next uniformly distributed 32-bit value. */
+    std::uint32_t next();
+
+    /** Returns uniformly distributed number in range [min : max]. */
+    int getInt(int min, int max);
+
+private:
+    /** Restarts the stream if the common seed was changed since the last use. */
+    void update();
+
+    std::uint64_t m_nameHash;
+    std::uint32_t m_seedGeneration;
+    std::array<std::uint32_t, 2> m_key;
+    std::uint64_t m_counter;
+    std::array<std::uint32_t, 4> m_block;
+    std::size_t m_blockIndex;
+};
+
+/**
+ * Sets the common seed of random streams of the calling thread, restarting their sequences.
+ * Scenario loading sets it from the scenario map seed, so loads in server and client threads
+ * do not restart each other's streams.
+ */
+void setRandomSeed(std::uint64_t seed);
+
+/**
+ * Returns stream with specified name.
+ * Each thread has its own streams, so server and client scripts do not affect each other.
+ */
+RandomStream& getRandomStream(const std::string& name);
+
+/** Binds 'RandomStream' type and global 'getRandomStream' function. */
+void bindRandomStreams(sol::state& lua);
+
+} // namespace hooks
+
+#endif // RANDOMSTREAM_H
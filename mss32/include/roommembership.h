@@ -0,0 +1,67 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ROOMMEMBERSHIP_H
+#define ROOMMEMBERSHIP_H
+
+#include <RakNetTypes.h>
+#include <RakString.h>
+#include <cstdint>
+#include <unordered_map>
+
+namespace hooks {
+
+struct RakNetGuidHash
+{
+    std::size_t operator()(const SLNet::RakNetGUID& guid) const
+    {
+        return SLNet::RakNetGUID::ToUint32(guid);
+    }
+};
+
+/**
+ * Remote members of the room hosted by the server player.
+ * Members are indexed by their guids and by client ids the game knows them by,
+ * so messages addressed by the game do not scan the whole room.
+ */
+class RoomMembership
+{
+public:
+    using Members = std::unordered_map<SLNet::RakNetGUID, SLNet::RakString, RakNetGuidHash>;
+
+    /** @returns false if the member is already in the room. */
+    bool add(const SLNet::RakNetGUID& guid, const SLNet::RakString& name);
+    /** @returns false if there is no such member. */
+    bool remove(const SLNet::RakNetGUID& guid);
+    /** @returns guid of the removed member or UNASSIGNED_RAKNET_GUID if there is none. */
+    SLNet::RakNetGUID remove(const SLNet::RakString& name);
+
+    /** @returns guid of the member or UNASSIGNED_RAKNET_GUID if there is none. */
+    SLNet::RakNetGUID findGuid(std::uint32_t clientId) const;
+
+    const Members& getMembers() const;
+
+private:
+    Members m_members;
+    std::unordered_map<std::uint32_t /* client id */, SLNet::RakNetGUID> m_guidsByClientId;
+};
+
+} // namespace hooks
+
+#endif // ROOMMEMBERSHIP_H
@@ -0,0 +1,44 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SCENARIODUMP_H
+#define SCENARIODUMP_H
+
+#include <filesystem>
+
+namespace game {
+struct IMidgardObjectMap;
+}
+
+namespace hooks {
+
+/**
+ * Writes units, stacks and scenario variables of the object map as plain text lines
+ * '<object id> <field> <value>' sorted by object ids, so dumps of two saves can be compared
+ * with any text diff tool.
+ * @returns false if the file could not be written.
+ */
+bool dumpScenario(const game::IMidgardObjectMap* objectMap, const std::filesystem::path& fileName);
+
+/** Dumps the object map to a new timestamped file in 'ScenarioDumps' subfolder of the game. */
+void dumpScenario(const game::IMidgardObjectMap* objectMap);
+
+} // namespace hooks
+
+#endif // SCENARIODUMP_H
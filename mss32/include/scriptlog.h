@@ -0,0 +1,51 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SCRIPTLOG_H
+#define SCRIPTLOG_H
+
+#include <memory>
+#include <sol/sol.hpp>
+#include <string>
+
+namespace spdlog {
+class logger;
+}
+
+namespace hooks {
+
+/**
+ * Binds global 'log' table with 'trace', 'debug', 'info', 'warn' and 'error' functions
+ * that write to the logger. Calling the table itself logs with debug level like the old 'log'
+ * function did. Functions of the levels that are filtered out do nothing, so their arguments
+ * are never converted, and messages over 'debugging.scriptLogRateLimit' are dropped.
+ */
+void bindScriptLog(sol::state& lua, std::shared_ptr<spdlog::logger> logger);
+
+/**
+ * Creates 'log' table for the script environment if 'debugging.scriptLogLevels' setting
+ * has a level for the script file.
+ * @param chunkName name of the script chunk, '@' followed by the file path.
+ * @returns nil if the script uses global 'log' table.
+ */
+sol::object createScriptLog(sol::state& lua, const std::string& chunkName);
+
+} // namespace hooks
+
+#endif // SCRIPTLOG_H
@@ -0,0 +1,41 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SCRIPTMODULES_H
+#define SCRIPTMODULES_H
+
+struct lua_State;
+
+namespace hooks {
+
+/**
+ * Replaces standard Lua file searcher used by 'require' with the one that looks modules up
+ * in an index of files built once for each 'package.path' template inside the scripts folder.
+ * Other templates are probed file by file as the standard searcher does.
+ * Missing modules no longer cost a file probe per indexed template, compiled modules are shared
+ * between Lua states, and modules with the same name in different folders are reported.
+ */
+void installModuleSearcher(lua_State* lua);
+
+/** Forgets indexed module files, so modules added or removed since then are found. */
+void clearModuleIndex();
+
+} // namespace hooks
+
+#endif // SCRIPTMODULES_H
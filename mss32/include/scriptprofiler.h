@@ -0,0 +1,60 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SCRIPTPROFILER_H
+#define SCRIPTPROFILER_H
+
+struct lua_State;
+
+namespace hooks {
+
+/**
+ * Starts collecting call counts, inclusive time and allocations of Lua functions
+ * executed in the specified state. Does nothing unless 'profileScripts' debug setting is enabled.
+ */
+void installScriptProfiler(lua_State* lua);
+
+/**
+ * Writes profile collected so far to the game folder, called at the beginning of each turn:
+ * luaProfile.txt - per-function statistics grouped by calling hook,
+ * luaProfile.folded - collapsed stacks for flamegraph.pl.
+ */
+void writeScriptProfile();
+
+/**
+ * Attributes Lua calls made during the scope lifetime to the specified game hook.
+ * Scopes can be nested, the innermost one is used.
+ * The name should point to a string literal as it is stored without copying.
+ */
+class ScriptProfilerScope
+{
+public:
+    explicit ScriptProfilerScope(const char* hookName);
+    ~ScriptProfilerScope();
+
+    ScriptProfilerScope(const ScriptProfilerScope&) = delete;
+    ScriptProfilerScope& operator=(const ScriptProfilerScope&) = delete;
+
+private:
+    const char* m_prevHookName;
+};
+
+} // namespace hooks
+
+#endif // SCRIPTPROFILER_H
@@ -0,0 +1,88 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SCRIPTREGISTRY_H
+#define SCRIPTREGISTRY_H
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <sol/sol.hpp>
+#include <string>
+
+namespace hooks {
+
+/** Script function together with the environment it executes in. */
+struct ScriptFunction
+{
+    std::optional<sol::environment> environment;
+    std::optional<sol::function> function;
+};
+
+/**
+ * Owns script functions that hooks call from c++ and loads each script only once.
+ * When 'debugging.reloadScripts' setting is enabled, script files are polled for changes
+ * and modified scripts are executed again, so they can be edited without restarting the game.
+ * Each thread that runs scripts has its own registry since functions belong to its Lua state.
+ */
+class ScriptRegistry
+{
+public:
+    /**
+     * Returns function with specified name, loads the script on first access.
+     * Result holds its own references, so it stays valid even if the script is reloaded
+     * while the function executes.
+     * @param[in] path script file.
+     * @param[in] name function name in lua script.
+     * @param[in] bindScenario true to bind global 'getScenario' function.
+     */
+    ScriptFunction getFunction(const std::filesystem::path& path,
+                               const char* name,
+                               bool bindScenario = true);
+
+    /**
+     * Executes scripts whose files were modified since they were loaded.
+     * Functions are replaced only if a script executes successfully,
+     * otherwise the error is logged and previous functions are kept.
+     */
+    void reloadChangedScripts();
+
+private:
+    struct Script
+    {
+        std::optional<sol::environment> environment;
+        std::map<std::string, std::optional<sol::function>> functions;
+        std::filesystem::file_time_type writeTime;
+        bool bindScenario;
+    };
+
+    void loadScript(const std::filesystem::path& path, Script& script);
+    bool reloadScript(const std::filesystem::path& path, Script& script);
+
+    std::map<std::filesystem::path, Script> m_scripts;
+    std::chrono::steady_clock::time_point m_lastPoll{};
+};
+
+/** Returns registry of the calling thread. */
+ScriptRegistry& getScriptRegistry();
+
+} // namespace hooks
+
+#endif // SCRIPTREGISTRY_H
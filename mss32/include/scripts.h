@@ -37,6 +37,15 @@ std::optional<sol::environment> executeScriptFile(const std::filesystem::path& p
                                                   bool alwaysExists = false,
                                                   bool bindScenario = false);
 
+/**
+ * Reads specified file again, ignoring cached source, and executes it.
+ * Unlike executeScriptFile does not show error messages.
+ * @param[out] error reason if the script could not be read or executed.
+ */
+std::optional<sol::environment> reloadScriptFile(const std::filesystem::path& path,
+                                                 bool bindScenario,
+                                                 std::string& error);
+
 /**
  * Returns function with specified name from lua environment to call from c++.
  * Return type is sol::function as std::function causes memory leaks in sol2 when function executes.
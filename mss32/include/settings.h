@@ -23,6 +23,7 @@
 #include <array>
 #include <cstdint>
 #include <filesystem>
+#include <map>
 #include <string>
 
 namespace game {
@@ -159,6 +160,21 @@ struct Settings
     {
         std::uint32_t sendObjectsChangesTreshold{0};
         bool logSinglePlayerMessages{false};
+        bool profileScripts{false};
+        bool reloadScripts{false};
+        // Minimal level of script log messages: trace, debug, info, warn, error or off.
+        // Empty means trace in debug mode and info otherwise.
+        std::string scriptLogLevel;
+        // Levels of specific scripts by their paths relative to the scripts folder.
+        std::map<std::string, std::string> scriptLogLevels;
+        // Maximum script log messages per second of each thread, 0 means no limit.
+        // Errors are never dropped.
+        std::uint32_t scriptLogRateLimit{0};
+        // Write units, stacks and variables to a text file each time the scenario is saved,
+        // so two saves can be compared with a text diff tool.
+        bool dumpScenarioOnSave{false};
+        // Record decisions of custom battle AI scripts to a file, see recordBattleAiDecision.
+        bool recordBattleAi{false};
     } debug;
 
     struct Engine
@@ -166,6 +182,8 @@ struct Settings
         // This is needed to split single CRefreshInfo into several instances when loading large
         // scenario, because it needs to fit to the network message buffer of 512 KB.
         std::uint32_t sendRefreshInfoObjectCountLimit{0};
+        // Maximum memory in megabytes that each Lua state can use, 0 means no limit.
+        std::uint32_t scriptMemoryLimit{0};
     } engine;
 
     struct Battle
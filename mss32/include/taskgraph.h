@@ -0,0 +1,105 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TASKGRAPH_H
+#define TASKGRAPH_H
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace hooks {
+
+/**
+ * Runs a set of loading tasks on a pool of threads respecting dependencies between them.
+ * Task fails if it returns false or throws an exception, tasks that depend on a failed task
+ * are skipped. Results are reported in the order tasks were added regardless of the order
+ * they were actually executed, so error reporting stays deterministic.
+ */
+class TaskGraph
+{
+public:
+    using Task = std::function<bool()>;
+    using TaskId = std::size_t;
+
+    enum class TaskStatus
+    {
+        Pending,
+        Succeeded,
+        Failed,
+        /** Not executed because one of its dependencies failed. */
+        Skipped,
+    };
+
+    struct TaskResult
+    {
+        std::string name;
+        TaskStatus status;
+        /** Exception message if task has thrown. */
+        std::string error;
+        std::chrono::steady_clock::duration duration;
+    };
+
+    /**
+     * Adds a task to the graph.
+     * @param[in] name task name used in reports.
+     * @param[in] task function to execute.
+     * @param[in] dependencies tasks that must succeed before this one starts.
+     * @param[in] callingThread true to execute the task on the thread that calls run.
+     * Use it for tasks that access game data that is not safe to read in parallel.
+     */
+    TaskId addTask(std::string name,
+                   Task task,
+                   const std::vector<TaskId>& dependencies = {},
+                   bool callingThread = false);
+
+    /**
+     * Executes all tasks and waits for them to finish.
+     * @param[in] threadCount maximum number of threads to use, including the calling thread.
+     * Zero means the number of hardware threads.
+     * @returns true if all tasks succeeded.
+     */
+    bool run(unsigned int threadCount = 0);
+
+    /** Returns task results in the order tasks were added. */
+    const std::vector<TaskResult>& getResults() const;
+
+    /** Writes per-task timings to the log. */
+    void logTimings(const char* graphName) const;
+
+private:
+    struct TaskInfo
+    {
+        Task task;
+        std::vector<TaskId> dependents;
+        std::size_t pendingDependencies;
+        bool dependencyFailed;
+        bool callingThread;
+    };
+
+    std::vector<TaskInfo> m_tasks;
+    std::vector<TaskResult> m_results;
+    std::chrono::steady_clock::duration m_runDuration{};
+};
+
+} // namespace hooks
+
+#endif // TASKGRAPH_H
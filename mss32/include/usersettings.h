@@ -89,6 +89,27 @@ struct Lobby
         std::uint16_t port{0};
     } client;
 
+    // Faults injected into received network packets to test bad connections
+    struct Faults
+    {
+        // Milliseconds
+        std::uint32_t delay{0};
+        std::uint32_t jitter{0};
+        // Percent of packets that are lost and resent
+        std::uint32_t lossChance{0};
+        // Chance per 10000 packets to lose connection
+        std::uint32_t disconnectChance{0};
+        std::uint32_t seed{0};
+    } faults;
+
+    // Subscribes to pushed online users and chat updates in custom lobby menu.
+    // Lobby server must support it, otherwise the client keeps polling
+    bool pushUpdates{false};
+
+    // Records network traffic to netCapture-*.bin files in the game folder.
+    // Lobby2 packets with login credentials are recorded without payload
+    bool captureTraffic{false};
+
     // Stores login information while the game is running,
     // not loaded from userSettings.lua.
     std::string password;
@@ -24,6 +24,7 @@
 #include "midgardid.h"
 #include "midscenvariables.h"
 #include <filesystem>
+#include <fstream>
 #include <functional>
 #include <string>
 
@@ -126,7 +127,11 @@ std::uint32_t createMessageEvent(game::UiEvent* messageEvent,
                                  void* callback,
                                  const char* messageName);
 
-/** Computes MD5 hash of specified files. */
+/**
+ * Computes MD5 hash of specified files.
+ * Results are cached in memory for the game session by file paths, sizes and write times,
+ * so unchanged files are not read again when rooms are created or joined.
+ */
 std::string computeHash(std::vector<std::filesystem::path> filenames);
 
 /** Executes function for each scenario object with specified id type. */
@@ -151,6 +156,26 @@ void allocateString(char** dest, const char* src);
 
 bool writeResourceToFile(const std::filesystem::path& path, int resourceId, bool rewriteExisting);
 
+/**
+ * Creates new file '<prefix>-<date>-<time>-<milliseconds>.<extension>' in specified folder,
+ * creating the folder if needed. Adds a counter to the name if such file already exists,
+ * so files created at the same time do not overwrite each other.
+ * @returns path of the file, check the stream to know if it was opened.
+ */
+std::filesystem::path createTimestampedFile(std::ofstream& stream,
+                                            const std::filesystem::path& folder,
+                                            const char* prefix,
+                                            const char* extension,
+                                            bool binary);
+
+/** Writes value to binary stream in little-endian byte order. */
+template <typename T>
+static inline void writeLittleEndian(std::ostream& stream, T value)
+{
+    // Game runs on x86 only, so native byte order is little-endian
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
 } // namespace hooks
 
 #endif // UTILS_H
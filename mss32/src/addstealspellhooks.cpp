@@ -39,6 +39,7 @@
 #include "midpopupinterf.h"
 #include "midsite.h"
 #include "midsitemage.h"
+#include "scriptregistry.h"
 #include "scripts.h"
 #include "spellutils.h"
 #include "spellview.h"
@@ -60,14 +61,6 @@ namespace hooks {
 
 thread_local StealSpellBuildContext g_stealSpellCtx;
 
-//
-// lua
-//
-
-static std::optional<sol::environment> env;
-
-static std::optional<sol::function> theftFilterMageTowerLua;
-
 //
 // scenario variable
 //
@@ -197,21 +190,9 @@ bool shouldDisplayStealSpell(const game::CMidgardID* spellId)
     // lua has priority
     //
 
-    if (!theftFilterMageTowerLua) {
-
-        const auto path{scriptsFolder() / "theft.lua"};
-
-        theftFilterMageTowerLua = getScriptFunction(path, "theftFilterMageTower", env, false, true);
-
-        if (theftFilterMageTowerLua) {
-
-            spdlog::info("[STEAL_SPELL] theft.lua loaded");
-
-        } else {
-
-            spdlog::info("[STEAL_SPELL] failed to load theft.lua");
-        }
-    }
+    const auto theftFilterMageTowerLua{
+        getScriptRegistry().getFunction(scriptsFolder() / "theft.lua", "theftFilterMageTower")
+            .function};
 
     //
     // lua
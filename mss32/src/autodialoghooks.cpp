@@ -22,12 +22,37 @@
 #include "autodialog.h"
 #include "autodialogfile.h"
 #include "dialogdescriptor.h"
+#include "dialogscriptparser.h"
 #include "mempool.h"
 #include "originalfunctions.h"
+#include "settings.h"
 #include "utils.h"
+#include <spdlog/spdlog.h>
 
 namespace hooks {
 
+/**
+ * Reports errors in interface script before the game parses it.
+ * Game parser either crashes or silently skips malformed lines, which makes errors in modified
+ * scripts hard to find. The script is parsed twice, so it is only checked in debug mode.
+ */
+static void checkDialogScript(const std::filesystem::path& path)
+{
+    if (!gameSettings().debugMode) {
+        return;
+    }
+
+    DialogScript script;
+    if (!loadDialogScript(path, script)) {
+        return;
+    }
+
+    for (const auto& error : script.errors) {
+        spdlog::warn("{:s}({:d},{:d}): {:s}", path.filename().string(), error.line, error.column,
+                     error.message);
+    }
+}
+
 bool __fastcall autoDialogLoadAndParseScriptFileHooked(game::CAutoDialog* thisptr,
                                                        int /*%edx*/,
                                                        const char* filePath)
@@ -38,6 +63,8 @@ bool __fastcall autoDialogLoadAndParseScriptFileHooked(game::CAutoDialog* thispt
     const auto& autoDialogFileApi = AutoDialogFileApi::get();
     const auto& dialogDescriptorApi = DialogDescriptorApi::get();
 
+    checkDialogScript(filePath);
+
     bool result = getOriginalFunctions().autoDialogLoadAndParseScriptFile(thisptr, filePath);
     if (!result) {
         return false;
@@ -28,6 +28,7 @@
 #include "battlemsgdataviewmutable.h"
 #include "gameutils.h"
 #include "groupview.h"
+#include "scriptprofiler.h"
 #include "scripts.h"
 #include "resultsender.h"
 #include <spdlog/spdlog.h>
@@ -121,6 +122,7 @@ void __fastcall updateGroupsIfBattleIsOverHooked(game::CBatLogic* thisptr,
 
     if (std::optional OnBattleEnd = getScriptFunction(scriptPath, "OnBattleEnd", env, false, true)) {
         try {
+            const ScriptProfilerScope profilerScope{"OnBattleEnd"};
             const IMidgardObjectMap* globalObjMap = hooks::getObjectMap();
             if (const CMidUnitGroup* winnerGroup = hooks::getGroup(globalObjMap, &winnerGroupId)) {
                 const bindings::GroupView win{winnerGroup, globalObjMap, &winnerGroupId};
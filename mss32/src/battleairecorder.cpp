@@ -0,0 +1,116 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "battleairecorder.h"
+#include "battlemsgdata.h"
+#include "midgardid.h"
+#include "utils.h"
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <spdlog/spdlog.h>
+
+namespace hooks {
+
+static constexpr std::uint32_t recordVersion{1};
+
+static void writeId(std::ofstream& stream, const game::CMidgardID* id)
+{
+    writeLittleEndian(stream, static_cast<std::uint32_t>((id ? id : &game::emptyId)->value));
+}
+
+static void writeTargets(std::ofstream& stream,
+                         const game::CMidgardID* groupId,
+                         const game::TargetSet* targets)
+{
+    writeId(stream, groupId);
+    writeLittleEndian(stream, static_cast<std::uint32_t>(targets ? targets->length : 0));
+    if (targets) {
+        for (int position : *targets) {
+            writeLittleEndian(stream, static_cast<std::int32_t>(position));
+        }
+    }
+}
+
+/** Creates record file on first use, so nothing is created unless AI makes decisions. */
+static std::ofstream* getRecordStream()
+{
+    static std::ofstream stream;
+    static bool opened{false};
+
+    if (opened) {
+        return stream.is_open() ? &stream : nullptr;
+    }
+
+    opened = true;
+
+    const auto path{createTimestampedFile(stream, gameFolder(), "battleAi", "bin", true)};
+    if (!stream) {
+        spdlog::error("Could not create battle AI record file '{:s}'", path.string());
+        return nullptr;
+    }
+
+    stream.write("D2AI", 4);
+    writeLittleEndian(stream, recordVersion);
+
+    spdlog::info("Recording battle AI decisions to '{:s}'", path.string());
+    return &stream;
+}
+
+void recordBattleAiDecision(const std::string& scriptPath,
+                            const game::BattleMsgData* battleMsgData,
+                            const game::CMidgardID* unitId,
+                            const game::Set<game::BattleAction>* possibleActions,
+                            const game::PossibleTargets* possibleTargets,
+                            game::BattleAction battleAction,
+                            const game::CMidgardID* targetUnitId,
+                            const game::CMidgardID* attackerUnitId)
+{
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto stream = getRecordStream();
+    if (!stream) {
+        return;
+    }
+
+    writeLittleEndian(*stream, static_cast<std::uint32_t>(scriptPath.size()));
+    stream->write(scriptPath.data(), scriptPath.size());
+
+    stream->write(reinterpret_cast<const char*>(battleMsgData), sizeof(game::BattleMsgData));
+    writeId(*stream, unitId);
+
+    writeLittleEndian(*stream, static_cast<std::uint32_t>(possibleActions->length));
+    for (auto action : *possibleActions) {
+        writeLittleEndian(*stream, static_cast<std::int32_t>(action));
+    }
+
+    writeTargets(*stream, possibleTargets->attackTargetGroupId, possibleTargets->attackTargets);
+    writeTargets(*stream, possibleTargets->item1TargetGroupId, possibleTargets->item1Targets);
+    writeTargets(*stream, possibleTargets->item2TargetGroupId, possibleTargets->item2Targets);
+
+    writeLittleEndian(*stream, static_cast<std::int32_t>(battleAction));
+    writeId(*stream, targetUnitId);
+    writeId(*stream, attackerUnitId);
+
+    // Keep decisions made before a crash
+    stream->flush();
+}
+
+} // namespace hooks
@@ -20,6 +20,7 @@
 #include "battlemsgdatahooks.h"
 #include "attackview.h"
 #include "batattack.h"
+#include "battleairecorder.h"
 #include "bindings/battlemsgdataviewmutable.h"
 #include "bindings/groupview.h"
 #include "bindings/idview.h"
@@ -645,6 +646,11 @@ void __stdcall aiChooseBattleActionHooked(const game::IMidgardObjectMap* objectM
         *targetUnitId = chosenTargetId.id;
         *attackerUnitId = chosenAttackerId.id;
         *battleAction = static_cast<BattleAction>(chosenAction);
+
+        if (gameSettings().debug.recordBattleAi) {
+            recordBattleAiDecision(actionScript, battleMsgData, unitId, possibleActions,
+                                   possibleTargets, *battleAction, targetUnitId, attackerUnitId);
+        }
     } catch (const std::exception& e) {
         const auto message{
             fmt::format("Failed to run '{:s}' script. Reason: {:s}", path.string(), e.what())};
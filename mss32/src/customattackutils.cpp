@@ -40,6 +40,7 @@
 #include "midplayer.h"
 #include "midunit.h"
 #include "midunitgroup.h"
+#include "scriptprofiler.h"
 #include "scripts.h"
 #include "settings.h"
 #include "targetslistutils.h"
@@ -47,10 +48,20 @@
 #include "unitutils.h"
 #include "ussoldier.h"
 #include "utils.h"
+#include <mutex>
 #include <spdlog/spdlog.h>
+#include <unordered_map>
 
 namespace hooks {
 
+/**
+ * Results of targeting scripts that declared 'pureTargets', mapped by script file.
+ * Each result is a list of indices of returned slots among attacker, selected, targets and allies.
+ */
+using PureTargets = std::unordered_map<std::uint64_t /* slots key */, std::vector<std::uint8_t>>;
+static std::unordered_map<std::string, PureTargets> pureTargetsCache;
+static std::mutex pureTargetsMutex;
+
 void fillCustomAttackSources(const std::filesystem::path& dbfFilePath)
 {
     using namespace game;
@@ -174,6 +185,119 @@ void fillCustomAttackReaches(const std::filesystem::path& dbfFilePath)
     }
 }
 
+static std::uint64_t getSlotKey(const bindings::UnitSlotView& slot)
+{
+    auto unit = slot.getUnit();
+
+    // Position in range [-1 : 5] shifted to 3 bits, occupied and big unit flags
+    std::uint64_t key = slot.getPosition() + 1;
+    if (unit) {
+        key |= 0x8;
+        if (!isUnitSmall(unit)) {
+            key |= 0x10;
+        }
+    }
+
+    return key;
+}
+
+/** Returns false if slots are not ordered by position, so their order can not be restored. */
+static bool getSlotsKey(const UnitSlots& slots, std::uint64_t& key)
+{
+    // Position, occupied and big unit bits for each of 6 slots
+    key = 0;
+    int previous = -1;
+    for (const auto& slot : slots) {
+        const int position = slot.getPosition();
+        if (position <= previous || position > 5) {
+            return false;
+        }
+
+        previous = position;
+        key |= 1ull << position;
+
+        if (auto unit = slot.getUnit()) {
+            key |= 1ull << (6 + position);
+            if (!isUnitSmall(unit)) {
+                key |= 1ull << (12 + position);
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Packs everything the result of a pure targeting script depends on into a single key:
+ * slots of targets and allies, attacker and selected slots and whether targets are allies.
+ */
+static bool getPureTargetsKey(const bindings::UnitSlotView& attacker,
+                              const bindings::UnitSlotView& selected,
+                              const UnitSlots& allies,
+                              const UnitSlots& targets,
+                              bool targetsAreAllies,
+                              std::uint64_t& key)
+{
+    std::uint64_t targetsKey{};
+    std::uint64_t alliesKey{};
+    if (!getSlotsKey(targets, targetsKey) || !getSlotsKey(allies, alliesKey)) {
+        return false;
+    }
+
+    key = targetsKey | alliesKey << 18 | getSlotKey(attacker) << 36 | getSlotKey(selected) << 41
+          | (targetsAreAllies ? 1ull << 46 : 0ull);
+    return true;
+}
+
+static const bindings::UnitSlotView* getCandidate(const bindings::UnitSlotView& attacker,
+                                                  const bindings::UnitSlotView& selected,
+                                                  const UnitSlots& allies,
+                                                  const UnitSlots& targets,
+                                                  std::size_t index)
+{
+    if (index == 0) {
+        return &attacker;
+    }
+
+    if (index == 1) {
+        return &selected;
+    }
+
+    index -= 2;
+    if (index < targets.size()) {
+        return &targets[index];
+    }
+
+    index -= targets.size();
+    return index < allies.size() ? &allies[index] : nullptr;
+}
+
+/** Returns false if some of the slots are not among the candidates. */
+static bool getCandidateIndices(const bindings::UnitSlotView& attacker,
+                                const bindings::UnitSlotView& selected,
+                                const UnitSlots& allies,
+                                const UnitSlots& targets,
+                                const UnitSlots& slots,
+                                std::vector<std::uint8_t>& indices)
+{
+    indices.reserve(slots.size());
+    for (const auto& slot : slots) {
+        std::size_t index = 0;
+        auto candidate = getCandidate(attacker, selected, allies, targets, index);
+        while (candidate && !(*candidate == slot)) {
+            candidate = getCandidate(attacker, selected, allies, targets, ++index);
+        }
+
+        if (!candidate) {
+            return false;
+        }
+
+        indices.push_back(static_cast<std::uint8_t>(index));
+    }
+
+    return true;
+}
+
 UnitSlots getTargetsToSelectOrAttack(const std::string& scriptFile,
                                      const bindings::UnitSlotView& attacker,
                                      const bindings::UnitSlotView& selected,
@@ -191,10 +315,42 @@ UnitSlots getTargetsToSelectOrAttack(const std::string& scriptFile,
         return UnitSlots();
     }
 
+    // Results of pure scripts depend only on slots, so each combination is computed once.
+    // Reloaded scripts can change their results, do not remember them.
+    std::uint64_t key{};
+    const bool pure = !gameSettings().debug.reloadScripts && env
+                      && (*env)["pureTargets"].get_or(false)
+                      && getPureTargetsKey(attacker, selected, allies, targets,
+                                           targetsAreAllies, key);
+    if (pure) {
+        std::lock_guard<std::mutex> lock(pureTargetsMutex);
+
+        const auto& cache = pureTargetsCache[scriptFile];
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+            UnitSlots value;
+            value.reserve(it->second.size());
+            for (auto index : it->second) {
+                value.push_back(*getCandidate(attacker, selected, allies, targets, index));
+            }
+
+            return value;
+        }
+    }
+
     try {
+        const ScriptProfilerScope profilerScope{"AttackReach"};
         sol::table result = (*getTargets)(attacker, selected, allies, targets, targetsAreAllies,
                                           item ? &item.value() : nullptr, battle, isMarking);
-        return result.as<UnitSlots>();
+        auto value = result.as<UnitSlots>();
+
+        std::vector<std::uint8_t> indices;
+        if (pure && getCandidateIndices(attacker, selected, allies, targets, value, indices)) {
+            std::lock_guard<std::mutex> lock(pureTargetsMutex);
+            pureTargetsCache[scriptFile].emplace(key, std::move(indices));
+        }
+
+        return value;
     } catch (const std::exception& e) {
         showErrorMessageBox(fmt::format("Failed to run '{:s}' script.\n"
                                         "Reason: '{:s}'",
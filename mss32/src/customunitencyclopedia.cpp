@@ -19,8 +19,13 @@
 
 #include "customunitencyclopedia.h"
 #include "customunitencyclopediafunctions.h"
+#include "midunit.h"
+#include "modifierutils.h"
+#include "ummodifier.h"
 #include <fmt/format.h>
 #include <thread>
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
 
 extern std::thread::id mainThreadId;
 
@@ -28,6 +33,20 @@ namespace hooks {
 
 static const char* SCRIPT_FILE_NAME = "unitEncyclopedia.lua";
 
+// Encyclopedia shows a single unit at a time, the limit only protects from unbounded growth
+static const std::size_t TEXT_CACHE_SIZE_MAX = 64;
+
+template <typename T>
+static std::string joinIds(const std::vector<T>& ids)
+{
+    std::string result;
+    for (auto id : ids) {
+        result += fmt::format("{:d},", static_cast<int>(id));
+    }
+
+    return result;
+}
+
 CustomUnitEncyclopedia::CustomUnitEncyclopedia()
     : mainThreadFunctions(nullptr)
     , workerThreadFunctions(nullptr)
@@ -49,8 +68,17 @@ std::string CustomUnitEncyclopedia::getTxtStatsText(
     const std::vector<game::AttackSourceId>& removedSourceWards,
     const std::vector<game::AttackClassId>& removedClassWards) const
 {
-    return getValue(getFunctions().getTxtStatsText, unit, unitImpl, isMaxLevel, isInBattle,
-                    fortificationArmor, shatteredArmor, removedSourceWards, removedClassWards);
+    auto key = getCacheKey("getTxtStatsText", unit, unitImpl);
+    if (!key.empty()) {
+        key += fmt::format("|{:d}|{:d}|{:d}|{:d}|{:s}|{:s}", isMaxLevel, isInBattle,
+                           fortificationArmor, shatteredArmor, joinIds(removedSourceWards),
+                           joinIds(removedClassWards));
+    }
+
+    return getCachedValue(std::move(key), [&]() {
+        return getValue(getFunctions().getTxtStatsText, unit, unitImpl, isMaxLevel, isInBattle,
+                        fortificationArmor, shatteredArmor, removedSourceWards, removedClassWards);
+    });
 }
 
 std::string CustomUnitEncyclopedia::getTxtStats2Text(const game::CMidUnit* unit,
@@ -61,14 +89,24 @@ std::string CustomUnitEncyclopedia::getTxtStats2Text(const game::CMidUnit* unit,
                                                      int unitRegen,
                                                      const std::string& pattern) const
 {
-    return getValue(getFunctions().getTxtStats2Text, unit, unitImpl, isInBattle, fortificationArmor,
-                    shatteredArmor, unitRegen, pattern);
+    auto key = getCacheKey("getTxtStats2Text", unit, unitImpl);
+    if (!key.empty()) {
+        key += fmt::format("|{:d}|{:d}|{:d}|{:d}|{:s}", isInBattle, fortificationArmor,
+                           shatteredArmor, unitRegen, pattern);
+    }
+
+    return getCachedValue(std::move(key), [&]() {
+        return getValue(getFunctions().getTxtStats2Text, unit, unitImpl, isInBattle,
+                        fortificationArmor, shatteredArmor, unitRegen, pattern);
+    });
 }
 
 std::string CustomUnitEncyclopedia::getTxtLeaderInfoText(const game::CMidUnit* unit,
                                                          const game::IUsUnit* unitImpl) const
 {
-    return getValue(getFunctions().getTxtLeaderInfoText, unit, unitImpl);
+    return getCachedValue(getCacheKey("getTxtLeaderInfoText", unit, unitImpl), [&]() {
+        return getValue(getFunctions().getTxtLeaderInfoText, unit, unitImpl);
+    });
 }
 
 std::string CustomUnitEncyclopedia::getTxtAttackInfoText(const game::CMidUnit* unit,
@@ -77,8 +115,21 @@ std::string CustomUnitEncyclopedia::getTxtAttackInfoText(const game::CMidUnit* u
                                                          int lowerDamageLevel,
                                                          int lowerInitiativeLevel) const
 {
-    return getValue(getFunctions().getTxtAttackInfoText, unit, unitImpl, boostDamageLevel,
-                    lowerDamageLevel, lowerInitiativeLevel);
+    auto key = getCacheKey("getTxtAttackInfoText", unit, unitImpl);
+    if (!key.empty()) {
+        key += fmt::format("|{:d}|{:d}|{:d}", boostDamageLevel, lowerDamageLevel,
+                           lowerInitiativeLevel);
+    }
+
+    return getCachedValue(std::move(key), [&]() {
+        return getValue(getFunctions().getTxtAttackInfoText, unit, unitImpl, boostDamageLevel,
+                        lowerDamageLevel, lowerInitiativeLevel);
+    });
+}
+
+void CustomUnitEncyclopedia::clearCache() const
+{
+    textCache.clear();
 }
 
 void CustomUnitEncyclopedia::showScriptErrorMessage(const char* reason) const
@@ -100,6 +151,46 @@ const CustomUnitEncyclopediaFunctions& CustomUnitEncyclopedia::getFunctions() co
     return *functions;
 }
 
+std::string CustomUnitEncyclopedia::getCacheKey(const char* functionName,
+                                                const game::CMidUnit* unit,
+                                                const game::IUsUnit* unitImpl) const
+{
+    using namespace game;
+
+    // Encyclopedia is only shown by the main thread, do not share the cache with other threads
+    if (std::this_thread::get_id() != mainThreadId) {
+        return {};
+    }
+
+    if (textCache.size() >= TEXT_CACHE_SIZE_MAX) {
+        textCache.clear();
+    }
+
+    // Scripts can check modifier keys, texts are different for each combination of them
+    const int keyState = ((GetAsyncKeyState(VK_SHIFT) & 0x8000) ? 1 : 0)
+                         | ((GetAsyncKeyState(VK_CONTROL) & 0x8000) ? 2 : 0)
+                         | ((GetAsyncKeyState(VK_MENU) & 0x8000) ? 4 : 0);
+
+    auto key = fmt::format("{:s}|{:d}", functionName, keyState);
+    if (unit) {
+        key += fmt::format("|{:d}|{:d}|{:d}", unit->id.value, unit->currentHp, unit->currentXp);
+    }
+
+    // Applied modifiers and base implementation define modified unit stats
+    for (auto curr = unitImpl; curr;) {
+        auto modifier = castUnitToUmModifier(curr);
+        if (!modifier) {
+            key += fmt::format("|{:d}", curr->id.value);
+            break;
+        }
+
+        key += fmt::format("|{:d}", modifier->data->modifierId.value);
+        curr = modifier->data->prev;
+    }
+
+    return key;
+}
+
 CustomUnitEncyclopedia& getCustomUnitEncyclopedia()
 {
     static CustomUnitEncyclopedia value{};
@@ -0,0 +1,411 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "dialogscriptparser.h"
+#include <algorithm>
+#include <fmt/format.h>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <set>
+
+namespace hooks {
+
+struct DialogControlSpec
+{
+    const char* keyword;
+    DialogControlType type;
+    std::size_t argumentsMin;
+    std::size_t argumentsMax;
+    /** Arguments 1-4 are control rectangle coordinates. */
+    bool hasRect;
+};
+
+// Argument counts include control name and match the ones accepted by the game
+static const DialogControlSpec controlSpecs[] = {
+    {"BUTTON", DialogControlType::Button, 11, 12, true},
+    {"BUTTONSD", DialogControlType::ButtonSd, 11, 11, true},
+    {"TEXT", DialogControlType::Text, 8, 8, true},
+    {"IMAGE", DialogControlType::Image, 7, 7, true},
+    {"EDIT", DialogControlType::Edit, 10, 10, true},
+    {"LBOX", DialogControlType::ListBox, 21, 21, true},
+    {"TLBOX", DialogControlType::TextListBox, 22, 22, true},
+    {"SPIN", DialogControlType::Spin, 10, 10, true},
+    {"TOGGLESD", DialogControlType::ToggleSd, 9, 11, true},
+    {"RADIO", DialogControlType::Radio, 2, std::numeric_limits<std::size_t>::max(), false},
+};
+
+static const std::size_t dialogArgumentsCount{14};
+// Game stores dialog and control names in char[48]
+static const std::size_t nameLengthMax{47};
+
+static const DialogControlSpec* findControlSpec(DialogControlType type)
+{
+    for (const auto& spec : controlSpecs) {
+        if (spec.type == type) {
+            return &spec;
+        }
+    }
+
+    return nullptr;
+}
+
+static bool isBlank(char ch)
+{
+    return ch == ' ' || ch == '\t';
+}
+
+static bool isInteger(const std::string& value)
+{
+    std::size_t start = !value.empty() && value[0] == '-' ? 1 : 0;
+    if (start == value.length()) {
+        return false;
+    }
+
+    return std::all_of(value.begin() + start, value.end(),
+                       [](char ch) { return ch >= '0' && ch <= '9'; });
+}
+
+static void addError(DialogScript& script, int line, int column, std::string message)
+{
+    script.errors.push_back({line, column, std::move(message)});
+}
+
+/** Splits comma separated arguments, quoted arguments can contain commas. */
+static bool parseArguments(DialogScript& script,
+                           std::string_view line,
+                           std::size_t start,
+                           int lineNumber,
+                           std::vector<DialogScriptArgument>& arguments)
+{
+    std::size_t pos = start;
+    while (true) {
+        while (pos < line.length() && isBlank(line[pos])) {
+            ++pos;
+        }
+
+        DialogScriptArgument argument{};
+        argument.column = static_cast<int>(pos) + 1;
+
+        if (pos < line.length() && line[pos] == '"') {
+            const auto end = line.find('"', pos + 1);
+            if (end == std::string_view::npos) {
+                addError(script, lineNumber, argument.column, "Unterminated string");
+                return false;
+            }
+
+            argument.value = line.substr(pos + 1, end - pos - 1);
+            argument.quoted = true;
+
+            pos = end + 1;
+            while (pos < line.length() && isBlank(line[pos])) {
+                ++pos;
+            }
+
+            if (pos < line.length() && line[pos] != ',') {
+                addError(script, lineNumber, static_cast<int>(pos) + 1,
+                         "Expected ',' after string");
+                return false;
+            }
+        } else {
+            auto end = line.find(',', pos);
+            if (end == std::string_view::npos) {
+                end = line.length();
+            }
+
+            auto value = line.substr(pos, end - pos);
+            while (!value.empty() && isBlank(value.back())) {
+                value.remove_suffix(1);
+            }
+
+            argument.value = value;
+            pos = end;
+        }
+
+        arguments.push_back(std::move(argument));
+
+        if (pos >= line.length()) {
+            return true;
+        }
+
+        // Skip comma
+        ++pos;
+    }
+}
+
+DialogControlType getDialogControlType(std::string_view keyword)
+{
+    for (const auto& spec : controlSpecs) {
+        if (keyword == spec.keyword) {
+            return spec.type;
+        }
+    }
+
+    return DialogControlType::Unknown;
+}
+
+DialogScript parseDialogScript(std::string_view contents)
+{
+    enum class State
+    {
+        Outside,
+        ExpectBegin,
+        Body,
+    };
+
+    DialogScript script;
+    State state{State::Outside};
+    int lineNumber = 0;
+
+    std::size_t lineStart = 0;
+    while (lineStart < contents.length()) {
+        auto lineEnd = contents.find('\n', lineStart);
+        if (lineEnd == std::string_view::npos) {
+            lineEnd = contents.length();
+        }
+
+        auto line = contents.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+        ++lineNumber;
+
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+
+        std::size_t pos = 0;
+        while (pos < line.length() && isBlank(line[pos])) {
+            ++pos;
+        }
+
+        if (pos == line.length()) {
+            continue;
+        }
+
+        const int column = static_cast<int>(pos) + 1;
+        const auto keywordEnd = std::find_if(line.begin() + pos, line.end(), isBlank)
+                                - line.begin();
+        const auto keyword = line.substr(pos, keywordEnd - pos);
+
+        std::vector<DialogScriptArgument> arguments;
+        const bool hasArguments = std::any_of(line.begin() + keywordEnd, line.end(),
+                                              [](char ch) { return !isBlank(ch); });
+        if (hasArguments && !parseArguments(script, line, keywordEnd, lineNumber, arguments)) {
+            continue;
+        }
+
+        if (keyword == "DIALOG") {
+            if (state == State::ExpectBegin) {
+                addError(script, lineNumber, column, "Expected BEGIN before next DIALOG");
+            } else if (state == State::Body) {
+                addError(script, lineNumber, column, "Expected END before next DIALOG");
+            }
+
+            script.dialogs.push_back({std::move(arguments), {}, lineNumber, column});
+            state = State::ExpectBegin;
+        } else if (keyword == "BEGIN" || keyword == "END") {
+            const bool begin = keyword == "BEGIN";
+            if (state != (begin ? State::ExpectBegin : State::Body)) {
+                addError(script, lineNumber, column,
+                         fmt::format("Unexpected {:s}", std::string{keyword}));
+                continue;
+            }
+
+            if (hasArguments) {
+                addError(script, lineNumber, static_cast<int>(keywordEnd) + 1,
+                         fmt::format("{:s} does not have arguments", std::string{keyword}));
+            }
+
+            state = begin ? State::Body : State::Outside;
+        } else if (state != State::Body) {
+            addError(script, lineNumber, column,
+                     fmt::format("Control '{:s}' is outside of dialog body",
+                                 std::string{keyword}));
+        } else {
+            auto& controls = script.dialogs.back().controls;
+            controls.push_back({getDialogControlType(keyword), std::string{keyword},
+                                std::move(arguments), lineNumber, column});
+        }
+    }
+
+    if (state != State::Outside) {
+        const auto& dialog = script.dialogs.back();
+        addError(script, lineNumber, 1,
+                 fmt::format("Dialog '{:s}' at line {:d} is not closed with END",
+                             dialog.arguments.empty() ? "" : dialog.arguments[0].value,
+                             dialog.line));
+    }
+
+    return script;
+}
+
+static void validateName(DialogScript& script,
+                         const std::vector<DialogScriptArgument>& arguments,
+                         int line,
+                         int column,
+                         const char* what)
+{
+    if (arguments.empty() || arguments[0].value.empty()) {
+        addError(script, line, column, fmt::format("{:s} name is missing", what));
+        return;
+    }
+
+    const auto& name = arguments[0];
+    if (name.value.length() > nameLengthMax) {
+        addError(script, line, name.column,
+                 fmt::format("{:s} name '{:s}' is longer than {:d} characters", what, name.value,
+                             nameLengthMax));
+    }
+}
+
+static void validateRect(DialogScript& script,
+                         const std::vector<DialogScriptArgument>& arguments,
+                         int line)
+{
+    if (arguments.size() < 5) {
+        return;
+    }
+
+    for (std::size_t i = 1; i < 5; ++i) {
+        const auto& argument = arguments[i];
+        if (!isInteger(argument.value)) {
+            addError(script, line, argument.column,
+                     fmt::format("Expected integer coordinate, got '{:s}'", argument.value));
+            return;
+        }
+    }
+
+    const int left = std::stoi(arguments[1].value);
+    const int top = std::stoi(arguments[2].value);
+    const int right = std::stoi(arguments[3].value);
+    const int bottom = std::stoi(arguments[4].value);
+    if (left > right || top > bottom) {
+        addError(script, line, arguments[1].column,
+                 fmt::format("Invalid rectangle ({:d}, {:d}, {:d}, {:d})", left, top, right,
+                             bottom));
+    }
+}
+
+static void validateControl(DialogScript& script,
+                            const DialogScriptControl& control,
+                            const std::set<std::string>& controlNames)
+{
+    validateName(script, control.arguments, control.line, control.column, "Control");
+
+    // Controls of unknown types are kept as is, only their names are checked
+    const auto spec = findControlSpec(control.type);
+    if (!spec) {
+        return;
+    }
+
+    const auto count = control.arguments.size();
+    if (count < spec->argumentsMin || count > spec->argumentsMax) {
+        const auto expected = spec->argumentsMin == spec->argumentsMax
+                                  ? fmt::format("{:d}", spec->argumentsMin)
+                                  : fmt::format("{:d}-{:d}", spec->argumentsMin,
+                                                spec->argumentsMax);
+        addError(script, control.line, control.column,
+                 fmt::format("{:s} expects {:s} arguments, got {:d}", control.typeName, expected,
+                             count));
+        return;
+    }
+
+    if (spec->hasRect) {
+        validateRect(script, control.arguments, control.line);
+    }
+
+    if (control.type == DialogControlType::Radio) {
+        // Radio groups list toggle buttons of the same dialog
+        for (std::size_t i = 1; i < count; ++i) {
+            const auto& argument = control.arguments[i];
+            if (!controlNames.count(argument.value)) {
+                addError(script, control.line, argument.column,
+                         fmt::format("Radio button '{:s}' is not found in dialog",
+                                     argument.value));
+            }
+        }
+    }
+}
+
+void validateDialogScript(DialogScript& script)
+{
+    std::map<std::string, int> dialogLines;
+
+    for (const auto& dialog : script.dialogs) {
+        validateName(script, dialog.arguments, dialog.line, dialog.column, "Dialog");
+
+        if (dialog.arguments.size() != dialogArgumentsCount) {
+            addError(script, dialog.line, dialog.column,
+                     fmt::format("DIALOG expects {:d} arguments, got {:d}", dialogArgumentsCount,
+                                 dialog.arguments.size()));
+        } else {
+            validateRect(script, dialog.arguments, dialog.line);
+        }
+
+        if (!dialog.arguments.empty()) {
+            const auto& name = dialog.arguments[0].value;
+            // Game keeps the first dialog and silently ignores the rest
+            auto [it, inserted] = dialogLines.insert({name, dialog.line});
+            if (!inserted) {
+                addError(script, dialog.line, dialog.column,
+                         fmt::format("Dialog '{:s}' is already defined at line {:d}", name,
+                                     it->second));
+            }
+        }
+
+        std::map<std::string, int> controlLines;
+        std::set<std::string> controlNames;
+        for (const auto& control : dialog.controls) {
+            if (control.arguments.empty()) {
+                continue;
+            }
+
+            const auto& name = control.arguments[0].value;
+            auto [it, inserted] = controlLines.insert({name, control.line});
+            if (!inserted) {
+                addError(script, control.line, control.column,
+                         fmt::format("Control '{:s}' is already defined at line {:d}", name,
+                                     it->second));
+            }
+
+            controlNames.insert(name);
+        }
+
+        for (const auto& control : dialog.controls) {
+            validateControl(script, control, controlNames);
+        }
+    }
+}
+
+bool loadDialogScript(const std::filesystem::path& path, DialogScript& script)
+{
+    std::ifstream stream{path, std::ios_base::binary};
+    if (!stream) {
+        return false;
+    }
+
+    const std::string contents{std::istreambuf_iterator<char>(stream),
+                               std::istreambuf_iterator<char>()};
+
+    script = parseDialogScript(contents);
+    validateDialogScript(script);
+    return true;
+}
+
+} // namespace hooks
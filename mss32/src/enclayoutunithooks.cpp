@@ -339,6 +339,9 @@ void __fastcall encLayoutUnitDataDtorHooked(game::CEncLayoutUnitData* thisptr, i
     auto patched = (CEncLayoutUnitDataPatched*)thisptr;
     stringArrayApi.destructor(&patched->modifierTexts);
     imagePtrVectorApi.destructor(&patched->modifierIcons);
+
+    // Next encyclopedia should show up-to-date texts even if the unit state is the same
+    getCustomUnitEncyclopedia().clearCache();
 }
 
 void __fastcall encLayoutUnitInitializeHooked(game::CEncLayoutUnit* thisptr,
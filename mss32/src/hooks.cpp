@@ -167,6 +167,7 @@
 #include "midserverlogichooks.h"
 #include "midsite.h"
 #include "midstack.h"
+#include "midstreamenvfile.h"
 #include "midunitdescriptor.h"
 #include "midunitdescriptorhooks.h"
 #include "midunithooks.h"
@@ -190,13 +191,16 @@
 #include "playerincomehooks.h"
 #include "racecategory.h"
 #include "racetype.h"
+#include "randomstream.h"
 #include "restrictions.h"
 #include "scenariodata.h"
 #include "scenariodataarray.h"
+#include "scenariodump.h"
 #include "scenarioinfo.h"
 #include "scenedit.h"
 #include "scenedithooks.h"
 #include "scenpropinterfhooks.h"
+#include "scriptprofiler.h"
 #include "settings.h"
 #include "usersettings.h"
 #include "sitecategoryhooks.h"
@@ -918,6 +922,12 @@ Hooks getHooks()
                                     (void**)&orig.throwException});
     }
 
+    if (executableIsGame() && gameSettings().debug.dumpScenarioOnSave) {
+        // Dump scenario objects to a text file on each save, editor always hooks the stream
+        hooks.emplace_back(HookInfo{CMidgardScenarioMapApi::get().stream, scenarioMapStreamHooked,
+                                    (void**)&orig.scenarioMapStream});
+    }
+
     if (gameSettings().shatterDamageUpgradeRatio != baseGameSettings().shatterDamageUpgradeRatio) {
         // Allow users to customize shatter damage upgrade ratio
         hooks.emplace_back(
@@ -1791,6 +1801,7 @@ void __stdcall afterBattleTurnHooked(game::BattleMsgData* battleMsgData,
 
     if (f) {
         try {
+            const ScriptProfilerScope profilerScope{"OnAfterBattleTurn"};
             const auto& fn = gameFunctions();
             auto* objMap = getObjectMap();
 
@@ -1867,6 +1878,7 @@ void __stdcall beforeBattleTurnHooked(game::BattleMsgData* battleMsgData,
 
     if (f) {
         try {
+            const ScriptProfilerScope profilerScope{"OnBeforeBattleTurn"};
             const auto& fn = gameFunctions();
             if (CMidUnit* cMidUnit = fn.findUnitById(objectMap, unitId)) {
                 const bindings::BattleMsgDataView battleMsg{battleMsgData, objectMap};
@@ -2168,11 +2180,16 @@ void validateUnits(game::CMidgardScenarioMap* scenarioMap)
                           [](const IMidScenarioObject* obj) { validateUnit((CMidUnit*)obj); });
 }
 
+// Scenario files are loaded and saved through CMidStreamEnvFile, remember its vftable
+// to tell saves from other streams that write scenario map
+static const game::IMidgardStreamEnvVftable* streamEnvFileVftable{};
+
 int __stdcall loadScenarioMapHooked(int a1,
                                     game::CMidStreamEnvFile* streamEnv,
                                     game::CMidgardScenarioMap* scenarioMap)
 {
     stackTemplateCacheClear();
+    streamEnvFileVftable = streamEnv->vftable;
 
     const int result = getOriginalFunctions().loadScenarioMap(a1, streamEnv, scenarioMap);
     // Write-mode validation is done in midUnitStreamHooked
@@ -2180,6 +2197,13 @@ int __stdcall loadScenarioMapHooked(int a1,
 
     using namespace game;
 
+    // Loading the same save restarts script random streams with the same sequences
+    if (auto info = getScenarioInfo(scenarioMap)) {
+        setRandomSeed(static_cast<std::uint32_t>(info->mapSeed)
+                      | static_cast<std::uint64_t>(static_cast<std::uint32_t>(info->currentTurn))
+                            << 32);
+    }
+
     const auto& dynamicCast{RttiApi::get().dynamicCast};
     const auto& rtti{RttiApi::rtti()};
 
@@ -2201,8 +2225,14 @@ bool __fastcall scenarioMapStreamHooked(game::CMidgardScenarioMap* scenarioMap,
 {
     bool result = getOriginalFunctions().scenarioMapStream(scenarioMap, streamEnv);
     if (result && streamEnv->vftable->readMode(streamEnv)) {
-        // Write-mode validation is done in midUnitStreamHooked
-        validateUnits(scenarioMap);
+        // Game validates units in loadScenarioMapHooked, write-mode validation is done in
+        // midUnitStreamHooked
+        if (!executableIsGame()) {
+            validateUnits(scenarioMap);
+        }
+    } else if (result && gameSettings().debug.dumpScenarioOnSave
+               && streamEnv->vftable == streamEnvFileVftable) {
+        dumpScenario(scenarioMap);
     }
 
     return result;
@@ -2779,6 +2809,7 @@ static void callLuaHook(const char* funcName,
 
     if (f) {
         try {
+            const ScriptProfilerScope profilerScope{funcName};
             auto* unit = game::gameFunctions().findUnitById(map, id);
             (*f)(bindings::BattleMsgDataView{data, map}, bindings::UnitView{unit});
         } catch (const std::exception& e) {
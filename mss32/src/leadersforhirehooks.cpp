@@ -36,6 +36,7 @@
 #include "playerview.h"
 #include "racetype.h"
 #include "scenarioinfo.h"
+#include "scriptregistry.h"
 #include "scripts.h"
 #include "utils.h"
 #include "unitgenerator.h"
@@ -121,13 +122,10 @@ bool __stdcall getLeadersHireListHooked(const game::IMidgardObjectMap* objectMap
     listApi.pushBack(hireList, &nobleId);
 
 
-    static std::optional<sol::environment> env;
-    static std::optional<sol::function> processFunction;
-    const std::filesystem::path path = scriptsFolder() / "hire.lua";
-
-    if (!env && !processFunction) {
-        processFunction = getScriptFunction(path, "getLeadersHireList", env, false, true);
-    }
+    const auto script{getScriptRegistry().getFunction(scriptsFolder() / "hire.lua",
+                                                     "getLeadersHireList")};
+    const auto& env{script.environment};
+    const auto& processFunction{script.function};
 
     if (!processFunction) {
         return true;
@@ -241,13 +239,10 @@ bool __stdcall changeStackLeaderInCapitalHooked(game::IMidgardObjectMap* objectM
 
     auto player = getPlayer(objectMap, &playerId);
 
-    static std::optional<sol::environment> env;
-    static std::optional<sol::function> modifyFunc;
-    const std::filesystem::path path = scriptsFolder() / "hire.lua";
-
-    if (!env && !modifyFunc) {
-        modifyFunc = getScriptFunction(path, "getStartingLeader", env, false, true);
-    }
+    const auto script{getScriptRegistry().getFunction(scriptsFolder() / "hire.lua",
+                                                     "getStartingLeader")};
+    const auto& env{script.environment};
+    const auto& modifyFunc{script.function};
 
     CMidgardID newLeaderId = emptyId;
 
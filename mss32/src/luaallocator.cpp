@@ -0,0 +1,284 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "luaallocator.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <lua.hpp>
+#include <new>
+#include <spdlog/spdlog.h>
+
+namespace hooks {
+
+static const char* getAllocationKindName(std::size_t kind)
+{
+    switch (kind) {
+    case LUA_TSTRING:
+        return "string";
+    case LUA_TTABLE:
+        return "table";
+    case LUA_TFUNCTION:
+        return "function";
+    case LUA_TUSERDATA:
+        return "userdata";
+    case LUA_TTHREAD:
+        return "thread";
+    case LUA_NUMTYPES:
+        return "upvalue";
+    case LUA_NUMTYPES + 1:
+        return "prototype";
+    default:
+        return "other";
+    }
+}
+
+LuaAllocator::LuaAllocator(const char* name)
+    : m_name(name)
+    , m_memoryLimit(0)
+    , m_usedMemory(0)
+    , m_peakMemory(0)
+    , m_limitReported(false)
+    , m_sizeClasses{}
+    , m_allocationKinds{}
+    , m_chunkPosition(nullptr)
+    , m_chunkRemaining(0)
+{ }
+
+LuaAllocator::~LuaAllocator()
+{
+    for (auto chunk : m_chunks) {
+        std::free(chunk);
+    }
+}
+
+void* LuaAllocator::allocate(void* userData, void* ptr, std::size_t oldSize, std::size_t newSize)
+{
+    auto allocator = static_cast<LuaAllocator*>(userData);
+
+    if (!ptr) {
+        // When ptr is null, oldSize encodes the type of the object being allocated
+        const auto kind = std::min(oldSize, allocationKindCount - 1);
+        auto& stats = allocator->m_allocationKinds[kind];
+        ++stats.count;
+        stats.bytes += newSize;
+        oldSize = 0;
+    }
+
+    return allocator->reallocate(ptr, oldSize, newSize);
+}
+
+void LuaAllocator::setMemoryLimit(std::size_t value)
+{
+    m_memoryLimit = value;
+    m_limitReported = false;
+}
+
+std::size_t LuaAllocator::getUsedMemory() const
+{
+    return m_usedMemory;
+}
+
+std::size_t LuaAllocator::getPeakMemory() const
+{
+    return m_peakMemory;
+}
+
+void LuaAllocator::logStatistics() const
+{
+    spdlog::info("Lua state '{:s}' memory: used {:d} KB, peak {:d} KB, limit {:s}", m_name,
+                 m_usedMemory / 1024, m_peakMemory / 1024,
+                 m_memoryLimit ? fmt::format("{:d} KB", m_memoryLimit / 1024) : "none");
+
+    std::size_t pooledBytes = 0;
+    for (std::size_t i = 0; i < sizeClassCount; ++i) {
+        pooledBytes += m_sizeClasses[i].liveBlocks * (i + 1) * sizeClassGranularity;
+    }
+    spdlog::info("Lua state '{:s}' pools: {:d} chunks, {:d} KB in live pooled blocks", m_name,
+                 m_chunks.size(), pooledBytes / 1024);
+
+    std::array<std::size_t, allocationKindCount> kinds{};
+    for (std::size_t i = 0; i < kinds.size(); ++i) {
+        kinds[i] = i;
+    }
+
+    std::sort(kinds.begin(), kinds.end(), [this](std::size_t a, std::size_t b) {
+        return m_allocationKinds[a].bytes > m_allocationKinds[b].bytes;
+    });
+
+    for (auto kind : kinds) {
+        const auto& stats = m_allocationKinds[kind];
+        if (!stats.count) {
+            break;
+        }
+
+        spdlog::info("Lua state '{:s}' allocated {:d} objects of type '{:s}', {:d} KB total",
+                     m_name, stats.count, getAllocationKindName(kind), stats.bytes / 1024);
+    }
+}
+
+std::size_t LuaAllocator::getSizeClass(std::size_t size)
+{
+    return (size - 1) / sizeClassGranularity;
+}
+
+void* LuaAllocator::reallocate(void* ptr, std::size_t oldSize, std::size_t newSize)
+{
+    if (newSize == 0) {
+        if (ptr) {
+            freeBlock(ptr, oldSize);
+            m_usedMemory -= oldSize;
+        }
+
+        return nullptr;
+    }
+
+    // Lua assumes that shrinking never fails, so the limit only applies to growth
+    if (newSize > oldSize && m_memoryLimit && m_usedMemory + newSize - oldSize > m_memoryLimit) {
+        onLimitExceeded(newSize);
+        return nullptr;
+    }
+
+    if (ptr && oldSize <= maxPooledSize && newSize <= maxPooledSize
+        && getSizeClass(oldSize) == getSizeClass(newSize)) {
+        m_usedMemory = m_usedMemory - oldSize + newSize;
+        m_peakMemory = std::max(m_peakMemory, m_usedMemory);
+        return ptr;
+    }
+
+    // Shrinking must not fail for the same reason, old block is kept if a new one is not available
+    const bool shrink{ptr && newSize < oldSize};
+
+    void* block{};
+    if (ptr && oldSize > maxPooledSize && newSize > maxPooledSize) {
+        block = std::realloc(ptr, newSize);
+        if (!block) {
+            if (!shrink) {
+                return nullptr;
+            }
+
+            // Heap block of a larger size is still freed correctly
+            block = ptr;
+        }
+    } else {
+        block = allocateBlock(newSize);
+        if (!block) {
+            if (!shrink) {
+                return nullptr;
+            }
+
+            keepShrunkBlock(ptr, oldSize, newSize);
+            m_usedMemory = m_usedMemory - oldSize + newSize;
+            return ptr;
+        }
+
+        if (ptr) {
+            std::memcpy(block, ptr, std::min(oldSize, newSize));
+            freeBlock(ptr, oldSize);
+        }
+    }
+
+    m_usedMemory = m_usedMemory - oldSize + newSize;
+    m_peakMemory = std::max(m_peakMemory, m_usedMemory);
+    return block;
+}
+
+void* LuaAllocator::allocateBlock(std::size_t size)
+{
+    if (size > maxPooledSize) {
+        return std::malloc(size);
+    }
+
+    auto& sizeClass = m_sizeClasses[getSizeClass(size)];
+    if (sizeClass.freeBlocks) {
+        auto block = sizeClass.freeBlocks;
+        sizeClass.freeBlocks = block->next;
+        ++sizeClass.liveBlocks;
+        return block;
+    }
+
+    const auto blockSize = (getSizeClass(size) + 1) * sizeClassGranularity;
+    if (m_chunkRemaining < blockSize) {
+        // Tail of the previous chunk is lost, it is smaller than the largest size class
+        auto chunk = std::malloc(chunkSize);
+        if (!chunk) {
+            return nullptr;
+        }
+
+        m_chunks.push_back(chunk);
+        m_chunkPosition = static_cast<std::uint8_t*>(chunk);
+        m_chunkRemaining = chunkSize;
+    }
+
+    auto block = m_chunkPosition;
+    m_chunkPosition += blockSize;
+    m_chunkRemaining -= blockSize;
+    ++sizeClass.liveBlocks;
+    return block;
+}
+
+void LuaAllocator::keepShrunkBlock(void* ptr, std::size_t oldSize, std::size_t newSize)
+{
+    // Lua frees the block using its new size, so it joins the pool of the new size class.
+    // The block is larger than blocks of that class, it only wastes the difference
+    if (oldSize > maxPooledSize) {
+        try {
+            // Heap block is never freed by pool, release it together with the chunks
+            m_chunks.push_back(ptr);
+        } catch (const std::bad_alloc&) {
+            // Out of memory, the block stays in the pool until the process exits
+        }
+    } else {
+        --m_sizeClasses[getSizeClass(oldSize)].liveBlocks;
+    }
+
+    ++m_sizeClasses[getSizeClass(newSize)].liveBlocks;
+}
+
+void LuaAllocator::freeBlock(void* ptr, std::size_t size)
+{
+    if (size > maxPooledSize) {
+        std::free(ptr);
+        return;
+    }
+
+    auto& sizeClass = m_sizeClasses[getSizeClass(size)];
+    auto block = static_cast<FreeBlock*>(ptr);
+    block->next = sizeClass.freeBlocks;
+    sizeClass.freeBlocks = block;
+    --sizeClass.liveBlocks;
+}
+
+void LuaAllocator::onLimitExceeded(std::size_t requestedSize)
+{
+    // Lua runs emergency garbage collection and retries failed allocation,
+    // also scripts are likely to hit the limit repeatedly, so dump the details only once
+    if (m_limitReported) {
+        spdlog::debug("Lua state '{:s}' reached memory limit while allocating {:d} bytes", m_name,
+                      requestedSize);
+        return;
+    }
+
+    m_limitReported = true;
+    spdlog::error("Lua state '{:s}' reached memory limit of {:d} KB while allocating {:d} bytes",
+                  m_name, m_memoryLimit / 1024, requestedSize);
+    logStatistics();
+}
+
+} // namespace hooks
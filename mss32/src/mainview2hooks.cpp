@@ -34,6 +34,7 @@
 #include "midsite.h"
 #include "midtaskopeninterfparamresmarket.h"
 #include "originalfunctions.h"
+#include "pendingstackmoves.h"
 #include "phasegame.h"
 #include "scenarioinfo.h"
 #include "sitecategoryhooks.h"
@@ -245,8 +246,11 @@ void __fastcall mainView2CommandQueueCallbackHooked(game::CMainView2* thisptr, i
     if (message) {
         auto messageId = message->vftable->getId(message);
         if (messageId == CommandMsgId::MoveStackEnd) {
-            thisptr->phaseGame->data->midObjectLock->patched.movingStack = false;
-            spdlog::debug(__FUNCTION__ ": CMidObjectLock::movingStack set to false");
+            auto objectMap = phaseApi.getDataCache(&thisptr->phaseGame->phase);
+            if (confirmPendingStackMove(objectMap)) {
+                thisptr->phaseGame->data->midObjectLock->patched.movingStack = false;
+                spdlog::debug(__FUNCTION__ ": CMidObjectLock::movingStack set to false");
+            }
             commandQueueApi.processCommands(commandQueue);
             return;
         }
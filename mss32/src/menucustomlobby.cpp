@@ -106,6 +106,7 @@ CMenuCustomLobby::CMenuCustomLobby(game::CMenuPhase* menuPhase)
     initializeNetMsgEntries();
     service->addPeerCallback(&m_peerCallback);
     service->addRoomsCallback(&m_roomsCallback);
+    service->subscribeLobbyUpdates();
 
     initializeChatControls();
     initializeUserControls();
@@ -129,6 +130,7 @@ CMenuCustomLobby ::~CMenuCustomLobby()
 
     auto service = CNetCustomService::get();
     if (service) {
+        service->unsubscribeLobbyUpdates();
         service->removeRoomsCallback(&m_roomsCallback);
         service->removePeerCallback(&m_peerCallback);
     }
@@ -206,7 +208,7 @@ void CMenuCustomLobby::initializeChatControls()
         listBoxApi.assignDisplayTextFunctor(dialog, "LBOX_CHAT", dialogName, &functor, true);
         smartPtrApi.createOrFreeNoDtor(&functor, nullptr);
 
-        // Request saved chat messages
+        // Request saved chat messages in case lobby server does not push them on subscription
         CNetCustomService::get()->queryChatMessages();
     }
 
@@ -319,7 +321,8 @@ void CMenuCustomLobby::initializeUsersControls()
         ImagePtrVectorApi::get().reserve(&m_userIcons, 1);
         m_usersListBoxName = usersListBoxName;
 
-        // Request users list as soon as possible, no need to wait for event
+        // Request users list as soon as possible, no need to wait for event.
+        // The event only polls until lobby server starts pushing the changes.
         CNetCustomService::get()->queryOnlineUsers();
         createTimerEvent(&m_usersUpdateEvent, this, usersUpdateEventCallback,
                          usersUpdateEventInterval);
@@ -759,7 +762,10 @@ void __fastcall CMenuCustomLobby::roomsUpdateEventCallback(CMenuCustomLobby* /*t
 void __fastcall CMenuCustomLobby::usersUpdateEventCallback(CMenuCustomLobby* /*thisptr*/,
                                                            int /*%edx*/)
 {
-    CNetCustomService::get()->queryOnlineUsers();
+    auto service = CNetCustomService::get();
+    if (!service->onlineUsersSynced()) {
+        service->queryOnlineUsers();
+    }
 }
 
 void __fastcall CMenuCustomLobby::chatMessageRegenEventCallback(CMenuCustomLobby* thisptr,
@@ -1634,12 +1640,40 @@ void CMenuCustomLobby::PeerCallback::onPacketReceived(DefaultMessageIDTypes type
     }
 
     case ID_LOBBY_GET_ONLINE_USERS_RESPONSE: {
-        m_menu->updateUsers(CNetCustomService::get()->readOnlineUsers(packet));
+        auto service = CNetCustomService::get();
+        // Late response to the initial query is older than the pushed state
+        if (!service->onlineUsersSynced()) {
+            m_menu->updateUsers(service->readOnlineUsers(packet));
+        }
         break;
     }
 
     case ID_LOBBY_GET_CHAT_MESSAGES_RESPONSE: {
-        m_menu->updateChat(CNetCustomService::get()->readChatMessages(packet));
+        auto service = CNetCustomService::get();
+        if (!service->chatMessagesSynced()) {
+            m_menu->updateChat(service->readChatMessages(packet));
+        }
+        break;
+    }
+
+    case ID_LOBBY_ONLINE_USERS_SNAPSHOT:
+    case ID_LOBBY_ONLINE_USERS_DELTA: {
+        auto service = CNetCustomService::get();
+        if (service->onlineUsersSynced()) {
+            m_menu->updateUsers(service->getOnlineUsers());
+        }
+        break;
+    }
+
+    case ID_LOBBY_CHAT_MESSAGES_UPDATE: {
+        const auto& update = CNetCustomService::get()->getChatMessagesUpdate();
+        if (update.history) {
+            m_menu->updateChat(update.messages);
+        } else {
+            for (const auto& message : update.messages) {
+                m_menu->addChatMessage(message);
+            }
+        }
         break;
     }
     }
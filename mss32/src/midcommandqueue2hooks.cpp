@@ -57,6 +57,11 @@ void __fastcall midCommandQueue2PushHooked(game::CMidCommandQueue2* thisptr,
 
     const auto& commandQueueApi = CMidCommandQueue2Api::get();
 
+    // Outdated sequence numbers mean duplicates or stale counters, not lost commands.
+    // Commands are delivered reliably and in order by both DirectPlay and custom lobby peers,
+    // and the sequence counter is shared with commands addressed to specific players,
+    // so gaps between broadcast commands are expected and there is nothing to resend.
+    // Original Push drops such commands, which is the duplicate suppression we need.
     if (commandMsg->playerId == emptyId) {
         std::uint32_t sequenceNumber = commandMsg->sequenceNumber;
         std::uint32_t lastCommandSequenceNumber = *commandQueueApi.lastCommandSequenceNumber;
@@ -37,6 +37,7 @@
 #include "midgardobjectmap.h"
 #include "midgardstream.h"
 #include "radiobuttoninterf.h"
+#include "scriptprofiler.h"
 #include "scripts.h"
 #include "testcondition.h"
 #include "textboxinterf.h"
@@ -753,6 +754,7 @@ bool __fastcall testScriptDoTest(const CTestScript* thisptr,
     }
 
     const bindings::ScenarioView scenario{objectMap};
+    const ScriptProfilerScope profilerScope{"EventCondition"};
     result = (*checkCondition)(scenario);
     if (!result.valid()) {
         const sol::error err = result;
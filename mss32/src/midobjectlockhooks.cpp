@@ -20,6 +20,7 @@
 #include "midobjectlockhooks.h"
 #include "midcommandqueue2.h"
 #include "originalfunctions.h"
+#include "pendingstackmoves.h"
 #include <spdlog/spdlog.h>
 
 namespace hooks {
@@ -31,6 +32,7 @@ game::CMidObjectLock* __fastcall midObjectLockCtorHooked(game::CMidObjectLock* t
 {
     auto result = getOriginalFunctions().midObjectLockCtor(thisptr, commandQueue, dataCache);
     result->patched.movingStack = false;
+    clearPendingStackMoves();
     return result;
 }
 
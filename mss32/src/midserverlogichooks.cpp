@@ -45,6 +45,7 @@
 #include <chrono>
 #include <filesystem>
 #include <process.h>
+#include "scriptregistry.h"
 #include "scripts.h"
 #include <sol/sol.hpp>
 #include <spdlog/spdlog.h>
@@ -612,13 +613,10 @@ void __fastcall processZeroTurnHooked(game::CMidServerLogic* thisptr,
         return;
     }
     
-    static std::optional<sol::environment> env;
-    static std::optional<sol::function> func;
-    const std::filesystem::path path = scriptsFolder() / "turn.lua";
-
-    if (!env && !func) {
-        func = getScriptFunction(path, "processTurnZero", env, false, true);
-    }
+    const auto script{getScriptRegistry().getFunction(scriptsFolder() / "turn.lua",
+                                                     "processTurnZero")};
+    const auto& env{script.environment};
+    const auto& func{script.function};
 
     if (func) {
         try {
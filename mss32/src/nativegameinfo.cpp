@@ -20,7 +20,6 @@
 #include "nativegameinfo.h"
 #include "attack.h"
 #include "customattacks.h"
-#include "dbfaccess.h"
 #include "dbffile.h"
 #include "game.h"
 #include "generatorsettings.h"
@@ -30,6 +29,7 @@
 #include "itemcategory.h"
 #include "itemtypelist.h"
 #include "landmark.h"
+#include "midgardid.h"
 #include "nativeiteminfo.h"
 #include "nativelandmarkinfo.h"
 #include "nativeraceinfo.h"
@@ -38,12 +38,16 @@
 #include "racetype.h"
 #include "sitecategoryhooks.h"
 #include "strategicspell.h"
+#include "taskgraph.h"
 #include "ussoldierimpl.h"
 #include "usstackleader.h"
 #include "usunitimpl.h"
 #include "utils.h"
 #include <cassert>
+#include <list>
 #include <spdlog/spdlog.h>
+#include <string>
+#include <vector>
 
 namespace hooks {
 
@@ -93,11 +97,35 @@ static std::string translate(const std::string_view& string, std::uint8_t length
     return trimSpaces(buffer);
 }
 
-static bool readSiteText(rsg::SiteTexts& texts,
+/** Database texts as they are stored in file, not translated yet. */
+struct DbfTexts
+{
+    struct Record
+    {
+        std::string id;
+        std::string text;
+        std::string description;
+    };
+
+    std::vector<Record> records;
+    std::uint8_t textLength{};
+    std::uint8_t descriptionLength{};
+};
+
+/**
+ * Reads texts from database file without calling game functions, so it is safe to call
+ * from worker threads.
+ * @param[in] idColumnName name of identifier column or nullptr if there is none.
+ * @param[in] descriptionColumnName name of description column or nullptr if there is none.
+ */
+static bool readDbfTexts(DbfTexts& texts,
                          const std::filesystem::path& dbFilename,
+                         const char* textColumnName,
+                         const char* idColumnName = nullptr,
+                         const char* descriptionColumnName = nullptr,
                          bool readDescriptions = true)
 {
-    texts.clear();
+    texts.records.clear();
 
     utils::DbfFile db;
     if (!db.open(dbFilename)) {
@@ -105,20 +133,27 @@ static bool readSiteText(rsg::SiteTexts& texts,
         return false;
     }
 
-    const utils::DbfColumn* nameColumn{db.column("NAME")};
-    if (!nameColumn) {
+    const utils::DbfColumn* textColumn{db.column(textColumnName)};
+    if (!textColumn) {
+        spdlog::error("Missing '{:s}' column in {:s}", textColumnName,
+                      dbFilename.filename().string());
         return false;
     }
 
-    const utils::DbfColumn* descColumn{db.column("DESC")};
-    if (!descColumn) {
-        return false;
+    texts.textLength = textColumn->length;
+
+    if (descriptionColumnName) {
+        const utils::DbfColumn* descColumn{db.column(descriptionColumnName)};
+        if (!descColumn) {
+            spdlog::error("Missing '{:s}' column in {:s}", descriptionColumnName,
+                          dbFilename.filename().string());
+            return false;
+        }
+
+        texts.descriptionLength = descColumn->length;
     }
 
-    const std::uint8_t nameLength{nameColumn->length};
-    const std::uint8_t descriptionLength{descColumn->length};
     const std::uint32_t recordsTotal{db.recordsTotal()};
-
     for (std::uint32_t i = 0; i < recordsTotal; ++i) {
         utils::DbfRecord record;
         if (!db.record(record, i)) {
@@ -131,27 +166,42 @@ static bool readSiteText(rsg::SiteTexts& texts,
             continue;
         }
 
-        std::string name;
-        if (!record.value(name, "NAME")) {
+        DbfTexts::Record text;
+        if (idColumnName && !record.value(text.id, idColumnName)) {
             continue;
         }
 
-        rsg::SiteText text;
-        text.name = translate(name, nameLength);
+        if (!record.value(text.text, textColumnName)) {
+            continue;
+        }
 
-        if (readDescriptions) {
-            std::string description;
-            if (record.value(description, "DESC")) {
-                text.description = translate(description, descriptionLength);
-            }
+        if (descriptionColumnName && readDescriptions) {
+            record.value(text.description, descriptionColumnName);
         }
 
-        texts.emplace_back(std::move(text));
+        texts.records.emplace_back(std::move(text));
     }
 
     return true;
 }
 
+/** Translates site texts, calls game functions so must be called on the calling thread. */
+static void translateSiteTexts(rsg::SiteTexts& texts, const DbfTexts& dbfTexts)
+{
+    texts.clear();
+
+    for (const auto& record : dbfTexts.records) {
+        rsg::SiteText text;
+        text.name = translate(record.text, dbfTexts.textLength);
+
+        if (!record.description.empty()) {
+            text.description = translate(record.description, dbfTexts.descriptionLength);
+        }
+
+        texts.emplace_back(std::move(text));
+    }
+}
+
 NativeGameInfo::NativeGameInfo(const std::filesystem::path& gameFolderPath)
 {
     if (!readGameInfo(gameFolderPath)) {
@@ -371,11 +421,84 @@ bool NativeGameInfo::readGameInfo(const std::filesystem::path& gameFolderPath)
     // Load and process it manually
     const std::filesystem::path scenDataFolder{gameFolderPath / "ScenData"};
     const std::filesystem::path interfDataFolder{gameFolderPath / "Interf"};
+    const bool resourceMarketExists{customSiteCategories().exists};
+
+    // Game data and game functions are not guaranteed to be safe for parallel access,
+    // read them on the calling thread, stopping at the first failure
+    if (!rsg::readGeneratorSettings(gameFolderPath) || !readRacesInfo() || !readUnitsInfo()
+        || !readItemsInfo() || !readSpellsInfo() || !readLandmarksInfo()) {
+        return false;
+    }
+
+    // Database files are parsed in parallel,
+    // their texts are translated on the calling thread after that
+    TaskGraph tasks;
+
+    auto addTextsTask = [&tasks](const char* name, TaskGraph::Task read,
+                                 TaskGraph::Task translateTexts) {
+        const auto readTask{tasks.addTask(name, std::move(read))};
+        tasks.addTask(std::string{name} + " texts", std::move(translateTexts), {readTask}, true);
+    };
+
+    DbfTexts editorTexts;
+    addTextsTask(
+        "TAppEdit.dbf",
+        [&editorTexts, &interfDataFolder]() {
+            return readDbfTexts(editorTexts, interfDataFolder / "TAppEdit.dbf", "TEXT", "TXT_ID");
+        },
+        [this, &editorTexts]() { return readEditorInterfaceTexts(editorTexts); });
+
+    DbfTexts cityTexts;
+    addTextsTask(
+        "Cityname.dbf",
+        [&cityTexts, &scenDataFolder]() {
+            return readDbfTexts(cityTexts, scenDataFolder / "Cityname.dbf", "NAME");
+        },
+        [this, &cityTexts]() { return readCityNames(cityTexts); });
+
+    std::list<DbfTexts> siteTexts;
+    auto addSiteTextTask = [&addTextsTask, &siteTexts, &scenDataFolder](
+                               rsg::SiteTexts& texts, const char* dbFilename,
+                               bool readDescriptions = true) {
+        auto& dbfTexts{siteTexts.emplace_back()};
+        addTextsTask(
+            dbFilename,
+            [&dbfTexts, &scenDataFolder, dbFilename, readDescriptions]() {
+                return readDbfTexts(dbfTexts, scenDataFolder / dbFilename, "NAME", nullptr,
+                                    "DESC", readDescriptions);
+            },
+            [&texts, &dbfTexts]() {
+                translateSiteTexts(texts, dbfTexts);
+                return true;
+            });
+    };
+
+    addSiteTextTask(mercenaryTexts, "Campname.dbf");
+    addSiteTextTask(mageTexts, "Magename.dbf");
+    addSiteTextTask(merchantTexts, "Mercname.dbf");
+    addSiteTextTask(ruinTexts, "Ruinname.dbf", false);
+    addSiteTextTask(trainerTexts, "Trainame.dbf");
+    // If resource market feature exists, 'Marketname.dbf' must be valid
+    if (resourceMarketExists) {
+        addSiteTextTask(marketTexts, "Marketname.dbf");
+    }
+
+    const bool result{tasks.run()};
+    tasks.logTimings("Game info");
 
-    return rsg::readGeneratorSettings(gameFolderPath) && readRacesInfo() && readUnitsInfo()
-           && readItemsInfo() && readSpellsInfo() && readLandmarksInfo()
-           && readEditorInterfaceTexts(interfDataFolder) && readCityNames(scenDataFolder)
-           && readSiteTexts(scenDataFolder);
+    for (const auto& task : tasks.getResults()) {
+        if (task.status != TaskGraph::TaskStatus::Failed) {
+            continue;
+        }
+
+        if (task.error.empty()) {
+            spdlog::error("Could not read game info '{:s}'", task.name);
+        } else {
+            spdlog::error("Could not read game info '{:s}'. Reason: {:s}", task.name, task.error);
+        }
+    }
+
+    return result;
 }
 
 bool NativeGameInfo::readUnitsInfo()
@@ -718,112 +841,34 @@ bool NativeGameInfo::readRacesInfo()
     return true;
 }
 
-bool NativeGameInfo::readEditorInterfaceTexts(const std::filesystem::path& interfFolderPath)
+bool NativeGameInfo::readEditorInterfaceTexts(const DbfTexts& texts)
 {
     editorInterfaceTexts.clear();
 
-    const auto dbFilePath{interfFolderPath / "TAppEdit.dbf"};
-
-    utils::DbfFile db;
-    if (!db.open(dbFilePath)) {
-        spdlog::error("Could not open {:s}", dbFilePath.filename().string());
-        return false;
-    }
-
-    const utils::DbfColumn* textColumn{db.column("TEXT")};
-    if (!textColumn) {
-        spdlog::error("Missing 'TEXT' column in {:s}", dbFilePath.filename().string());
-        return false;
-    }
+    const auto& idApi{game::CMidgardIDApi::get()};
 
-    const std::uint8_t textLength{textColumn->length};
-    const std::uint32_t recordsTotal{db.recordsTotal()};
-
-    for (std::uint32_t i = 0; i < recordsTotal; ++i) {
-        utils::DbfRecord record;
-        if (!db.record(record, i)) {
-            spdlog::error("Could not read record {:d} from {:s}", i,
-                          dbFilePath.filename().string());
-            continue;
-        }
-
-        if (record.isDeleted()) {
+    for (const auto& record : texts.records) {
+        game::CMidgardID textId{};
+        idApi.fromString(&textId, record.id.c_str());
+        if (textId == game::invalidId) {
             continue;
         }
 
-        game::CMidgardID textId;
-        if (!utils::dbRead(textId, db, i, "TXT_ID")) {
-            continue;
-        }
-
-        std::string text;
-        if (!record.value(text, "TEXT")) {
-            continue;
-        }
-
-        editorInterfaceTexts[idToRsgId(textId)] = translate(text, textLength);
+        editorInterfaceTexts[idToRsgId(textId)] = translate(record.text, texts.textLength);
     }
 
     return true;
 }
 
-bool NativeGameInfo::readCityNames(const std::filesystem::path& scenDataFolderPath)
+bool NativeGameInfo::readCityNames(const DbfTexts& texts)
 {
     cityNames.clear();
 
-    const auto dbFilePath{scenDataFolderPath / "Cityname.dbf"};
-
-    utils::DbfFile db;
-    if (!db.open(dbFilePath)) {
-        spdlog::error("Could not open {:s}", dbFilePath.filename().string());
-        return false;
-    }
-
-    const utils::DbfColumn* nameColumn{db.column("NAME")};
-    if (!nameColumn) {
-        spdlog::error("Missing 'NAME' column in {:s}", dbFilePath.filename().string());
-        return false;
-    }
-
-    const std::uint8_t textLength{nameColumn->length};
-    const std::uint32_t recordsTotal{db.recordsTotal()};
-
-    for (std::uint32_t i = 0; i < recordsTotal; ++i) {
-        utils::DbfRecord record;
-        if (!db.record(record, i)) {
-            spdlog::error("Could not read record {:d} from {:s}", i,
-                          dbFilePath.filename().string());
-            continue;
-        }
-
-        if (record.isDeleted()) {
-            continue;
-        }
-
-        std::string name{};
-        if (!record.value(name, "NAME")) {
-            continue;
-        }
-
-        cityNames.push_back(translate(name, textLength));
+    for (const auto& record : texts.records) {
+        cityNames.push_back(translate(record.text, texts.textLength));
     }
 
     return true;
 }
 
-bool NativeGameInfo::readSiteTexts(const std::filesystem::path& scenDataFolderPath)
-{
-    const bool resourceMarketExists{customSiteCategories().exists};
-
-    return readSiteText(mercenaryTexts, scenDataFolderPath / "Campname.dbf")
-           && readSiteText(mageTexts, scenDataFolderPath / "Magename.dbf")
-           && readSiteText(merchantTexts, scenDataFolderPath / "Mercname.dbf")
-           && readSiteText(ruinTexts, scenDataFolderPath / "Ruinname.dbf", false)
-           && readSiteText(trainerTexts, scenDataFolderPath / "Trainame.dbf")
-           // If resource market feature exists, 'Marketname.dbf' must be valid
-           && (!resourceMarketExists
-               || (resourceMarketExists
-                   && readSiteText(marketTexts, scenDataFolderPath / "Marketname.dbf")));
-}
-
 } // namespace hooks
@@ -0,0 +1,104 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "netcapture.h"
+#include "utils.h"
+#include <GetTime.h>
+#include <MessageIdentifiers.h>
+#include <spdlog/spdlog.h>
+
+namespace hooks {
+
+/**
+ * Returns length of packet data that can be recorded.
+ * Lobby2 messages carry account names and plaintext passwords, only their ids are kept.
+ */
+static std::uint32_t getCaptureLength(const unsigned char* data, std::uint32_t length)
+{
+    std::uint32_t idOffset{0};
+    if (length > 0 && data[0] == ID_TIMESTAMP) {
+        idOffset = 1 + sizeof(SLNet::Time);
+    }
+
+    if (idOffset >= length) {
+        return length;
+    }
+
+    switch (data[idOffset]) {
+    case ID_LOBBY2_SEND_MESSAGE:
+    case ID_LOBBY2_SERVER_ERROR:
+        return idOffset + 1;
+    }
+
+    return length;
+}
+
+NetCapture::NetCapture(const std::filesystem::path& folder)
+    : m_start{std::chrono::steady_clock::now()}
+{
+    const auto now{std::chrono::system_clock::now()};
+
+    const auto path{createTimestampedFile(m_stream, folder, "netCapture", "bin", true)};
+    if (!m_stream) {
+        spdlog::error("Could not create network capture file '{:s}'", path.string());
+        return;
+    }
+
+    const auto startMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                             now.time_since_epoch())
+                             .count();
+
+    m_stream.write("D2NC", 4);
+    writeLittleEndian(m_stream, version);
+    writeLittleEndian(m_stream, static_cast<std::uint64_t>(startMs));
+
+    spdlog::info("Capturing network traffic to '{:s}'", path.string());
+}
+
+bool NetCapture::isOpen() const
+{
+    return m_stream.is_open();
+}
+
+void NetCapture::write(Direction direction,
+                       std::uint64_t peerGuid,
+                       const unsigned char* data,
+                       std::uint32_t length)
+{
+    using namespace std::chrono;
+
+    if (!isOpen()) {
+        return;
+    }
+
+    length = getCaptureLength(data, length);
+
+    const auto elapsed = duration_cast<milliseconds>(steady_clock::now() - m_start).count();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    writeLittleEndian(m_stream, static_cast<std::uint8_t>(direction));
+    writeLittleEndian(m_stream, static_cast<std::uint32_t>(elapsed));
+    writeLittleEndian(m_stream, peerGuid);
+    writeLittleEndian(m_stream, length);
+    m_stream.write(reinterpret_cast<const char*>(data), length);
+    // Keep the capture usable if the game crashes
+    m_stream.flush();
+}
+
+} // namespace hooks
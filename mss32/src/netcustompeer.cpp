@@ -19,12 +19,23 @@
 
 #include "netcustompeer.h"
 #include "uimanager.h"
+#include "utils.h"
+#include <BitStream.h>
+#include <MessageIdentifiers.h>
+#include <algorithm>
 #include <spdlog/spdlog.h>
 
 namespace hooks {
 
+// Retransmission of a lost reliable packet takes at least this long in addition to round trip
+static constexpr std::chrono::milliseconds minResendDelay{100};
+
 CNetCustomPeer::CNetCustomPeer(const char* packetNotificationMessageName)
     : m_packetNotificationSent(false)
+    , m_faults(userSettings().lobby.faults)
+    , m_faultsRandom(m_faults.seed)
+    , m_nextDueTime(0)
+    , m_receiving(false)
 {
     using namespace game;
 
@@ -39,11 +50,188 @@ CNetCustomPeer::CNetCustomPeer(const char* packetNotificationMessageName)
     m_packetNotificationMessageId = uiManagerApi.registerMessage(uiManager.data,
                                                                  packetNotificationMessageName);
     SmartPointerApi::get().createOrFree((SmartPointer*)&uiManager, nullptr);
+
+    if (InjectsFaults()) {
+        spdlog::warn("Injecting network faults: delay {:d} ms, jitter {:d} ms, loss {:d}%, "
+                     "disconnect chance {:d} per 10000 packets, seed {:d}",
+                     m_faults.delay, m_faults.jitter, m_faults.lossChance,
+                     m_faults.disconnectChance, m_faults.seed);
+    }
+
+    if (userSettings().lobby.captureTraffic) {
+        m_capture = std::make_unique<NetCapture>(gameFolder());
+    }
 }
 
 CNetCustomPeer::~CNetCustomPeer()
 {
     spdlog::debug(__FUNCTION__);
+
+    for (auto& delayed : m_delayedPackets) {
+        RakPeer::DeallocatePacket(delayed.packet);
+    }
+}
+
+SLNet::Packet* CNetCustomPeer::Receive()
+{
+    auto packet = ReceiveWithFaults();
+    if (packet && m_capture) {
+        m_capture->write(NetCapture::Direction::Received, packet->guid.g, packet->data,
+                         packet->length);
+    }
+
+    return packet;
+}
+
+std::uint32_t CNetCustomPeer::Send(const char* data,
+                                   const int length,
+                                   PacketPriority priority,
+                                   PacketReliability reliability,
+                                   char orderingChannel,
+                                   const SLNet::AddressOrGUID systemIdentifier,
+                                   bool broadcast,
+                                   std::uint32_t forceReceiptNumber)
+{
+    if (m_capture && data && length > 0) {
+        CaptureSent(systemIdentifier, broadcast, reinterpret_cast<const unsigned char*>(data),
+                    static_cast<std::uint32_t>(length));
+    }
+
+    return RakPeer::Send(data, length, priority, reliability, orderingChannel, systemIdentifier,
+                         broadcast, forceReceiptNumber);
+}
+
+std::uint32_t CNetCustomPeer::Send(const SLNet::BitStream* bitStream,
+                                   PacketPriority priority,
+                                   PacketReliability reliability,
+                                   char orderingChannel,
+                                   const SLNet::AddressOrGUID systemIdentifier,
+                                   bool broadcast,
+                                   std::uint32_t forceReceiptNumber)
+{
+    if (m_capture && bitStream) {
+        CaptureSent(systemIdentifier, broadcast, bitStream->GetData(),
+                    BITS_TO_BYTES(bitStream->GetNumberOfBitsUsed()));
+    }
+
+    return RakPeer::Send(bitStream, priority, reliability, orderingChannel, systemIdentifier,
+                         broadcast, forceReceiptNumber);
+}
+
+void CNetCustomPeer::AddGameMessageCallback(NetGameMessageCallback* callback)
+{
+    std::lock_guard lock(m_gameMessageCallbacksMutex);
+    if (std::find(m_gameMessageCallbacks.begin(), m_gameMessageCallbacks.end(), callback)
+        == m_gameMessageCallbacks.end()) {
+        m_gameMessageCallbacks.push_back(callback);
+    }
+}
+
+void CNetCustomPeer::RemoveGameMessageCallback(NetGameMessageCallback* callback)
+{
+    // Waits for routing in progress, so the callback is not used after removal
+    std::lock_guard lock(m_gameMessageCallbacksMutex);
+    m_gameMessageCallbacks.erase(std::remove(m_gameMessageCallbacks.begin(),
+                                             m_gameMessageCallbacks.end(), callback),
+                                 m_gameMessageCallbacks.end());
+}
+
+void CNetCustomPeer::RouteGameMessages()
+{
+    // Delayed packets are received by the main thread only
+    if (InjectsFaults()) {
+        return;
+    }
+
+    // Packet taken by the main thread may change state the following game messages depend on,
+    // like a room member that joined. Route them on the next attempt instead of waiting here.
+    if (!TryBeginReceive()) {
+        return;
+    }
+
+    RouteFrontGameMessages();
+    EndReceive();
+}
+
+bool CNetCustomPeer::TryBeginReceive()
+{
+    bool receiving = false;
+    return m_receiving.compare_exchange_strong(receiving, true);
+}
+
+void CNetCustomPeer::EndReceive()
+{
+    m_receiving = false;
+}
+
+void CNetCustomPeer::RouteFrontGameMessages()
+{
+    std::lock_guard lock(m_gameMessageCallbacksMutex);
+    if (m_gameMessageCallbacks.empty()) {
+        return;
+    }
+
+    while (true) {
+        packetReturnMutex.Lock();
+        auto packet = packetReturnQueue.IsEmpty() ? nullptr : packetReturnQueue.Peek();
+        packetReturnMutex.Unlock();
+
+        if (!packet || packet->length == 0) {
+            return;
+        }
+
+        // Callbacks may patch message headers in place, capture packet as it was received
+        std::vector<unsigned char> captured;
+        if (m_capture) {
+            captured.assign(packet->data, packet->data + packet->length);
+        }
+
+        bool consumed = false;
+        for (auto callback : m_gameMessageCallbacks) {
+            if (callback->onGameMessageReceived(packet)) {
+                consumed = true;
+                break;
+            }
+        }
+
+        if (!consumed) {
+            return;
+        }
+
+        if (m_capture) {
+            m_capture->write(NetCapture::Direction::Received, packet->guid.g, captured.data(),
+                             static_cast<std::uint32_t>(captured.size()));
+        }
+
+        // Packets are pushed to the back and popped only by the receiving thread,
+        // so the consumed one is still at the front
+        packetReturnMutex.Lock();
+        packetReturnQueue.Pop();
+        packetReturnMutex.Unlock();
+        RakPeer::DeallocatePacket(packet);
+    }
+}
+
+SLNet::Packet* CNetCustomPeer::ReceiveWithFaults()
+{
+    if (!InjectsFaults()) {
+        return RakPeer::Receive();
+    }
+
+    for (auto packet = RakPeer::Receive(); packet != nullptr; packet = RakPeer::Receive()) {
+        DelayPacket(packet);
+    }
+
+    if (m_delayedPackets.empty() || m_delayedPackets.front().dueTime > Clock::now()) {
+        return nullptr;
+    }
+
+    auto packet = m_delayedPackets.front().packet;
+    m_delayedPackets.pop_front();
+    m_nextDueTime = m_delayedPackets.empty()
+                        ? 0
+                        : m_delayedPackets.front().dueTime.time_since_epoch().count();
+    return packet;
 }
 
 bool CNetCustomPeer::IsPacketNotificationSent() const
@@ -68,11 +256,13 @@ void CNetCustomPeer::UpdateThreadCallback(RakPeerInterface* peer, void* /*data*/
     }
 
     CNetCustomPeer* customPeer = (CNetCustomPeer*)peer;
+    customPeer->RouteGameMessages();
+
     customPeer->packetReturnMutex.Lock();
     bool empty = customPeer->packetReturnQueue.IsEmpty();
     customPeer->packetReturnMutex.Unlock();
 
-    if (!empty && !customPeer->IsPacketNotificationSent()) {
+    if ((!empty || customPeer->IsDelayedPacketDue()) && !customPeer->IsPacketNotificationSent()) {
         spdlog::debug(
             __FUNCTION__ ": there are packets in the return queue, posting notification message");
         customPeer->SendPacketNotification();
@@ -96,4 +286,74 @@ void CNetCustomPeer::SendPacketNotification()
     SmartPointerApi::get().createOrFree((SmartPointer*)&uiManager, nullptr);
 }
 
+void CNetCustomPeer::CaptureSent(const SLNet::AddressOrGUID& systemIdentifier,
+                                 bool broadcast,
+                                 const unsigned char* data,
+                                 std::uint32_t length)
+{
+    auto guid = systemIdentifier.rakNetGuid;
+    if (broadcast) {
+        guid = SLNet::UNASSIGNED_RAKNET_GUID;
+    } else if (guid == SLNet::UNASSIGNED_RAKNET_GUID) {
+        guid = GetGuidFromSystemAddress(systemIdentifier.systemAddress);
+    }
+
+    m_capture->write(NetCapture::Direction::Sent, guid.g, data, length);
+}
+
+bool CNetCustomPeer::InjectsFaults() const
+{
+    return m_faults.delay || m_faults.jitter || m_faults.lossChance || m_faults.disconnectChance;
+}
+
+bool CNetCustomPeer::IsDelayedPacketDue() const
+{
+    const auto nextDueTime = m_nextDueTime.load();
+    return nextDueTime && nextDueTime <= Clock::now().time_since_epoch().count();
+}
+
+void CNetCustomPeer::DelayPacket(SLNet::Packet* packet)
+{
+    using namespace std::chrono;
+
+    std::uniform_int_distribution<std::uint32_t> jitter{0, m_faults.jitter};
+    std::uniform_int_distribution<std::uint32_t> percent{0, 99};
+    std::uniform_int_distribution<std::uint32_t> perTenThousand{0, 9999};
+
+    const milliseconds delay{m_faults.delay + jitter(m_faultsRandom)};
+    auto dueTime = Clock::now() + delay;
+    // Lost packet arrives with its retransmission after the resend timeout
+    if (percent(m_faultsRandom) < m_faults.lossChance) {
+        dueTime += delay + minResendDelay;
+    }
+
+    // Packets are reliable ordered, so a late packet holds back the ones that follow it
+    if (!m_delayedPackets.empty() && dueTime < m_delayedPackets.back().dueTime) {
+        dueTime = m_delayedPackets.back().dueTime;
+    }
+
+    if (perTenThousand(m_faultsRandom) < m_faults.disconnectChance) {
+        spdlog::warn(__FUNCTION__ ": injecting connection loss with 0x{:x}", packet->guid.g);
+        auto connectionLost = CreateConnectionLostPacket(packet);
+        RakPeer::DeallocatePacket(packet);
+        CloseConnection(connectionLost->systemAddress, false);
+        packet = connectionLost;
+    }
+
+    m_delayedPackets.push_back({packet, dueTime});
+    if (m_delayedPackets.size() == 1) {
+        m_nextDueTime = dueTime.time_since_epoch().count();
+    }
+}
+
+SLNet::Packet* CNetCustomPeer::CreateConnectionLostPacket(const SLNet::Packet* packet)
+{
+    auto result = AllocPacket(sizeof(SLNet::MessageID), _FILE_AND_LINE_);
+    result->data[0] = ID_CONNECTION_LOST;
+    result->systemAddress = packet->systemAddress;
+    result->guid = packet->guid;
+    result->wasGeneratedLocally = true;
+    return result;
+}
+
 } // namespace hooks
@@ -26,7 +26,6 @@
 #include "netcustomservice.h"
 #include "netcustomsession.h"
 #include "netmsg.h"
-#include <mutex>
 #include <slikenet/types.h>
 #include <spdlog/spdlog.h>
 
@@ -122,11 +121,11 @@ void CNetCustomPlayer::postMessageToReceive(const game::NetMessageHeader* messag
 {
     getLogger()->debug(__FUNCTION__ ": '{:s}' from 0x{:x}", message->messageClassName, idFrom);
 
-    auto msg = std::make_unique<unsigned char[]>(message->length);
-    std::memcpy(msg.get(), message, message->length);
-    {
-        std::lock_guard<std::mutex> lock(m_messagesMutex);
-        m_messages.push(IdMessagePair{idFrom, std::move(msg)});
+    const auto overflowCount = m_messages.overflowCount();
+    m_messages.push(idFrom, reinterpret_cast<const unsigned char*>(message), message->length);
+    if (m_messages.overflowCount() != overflowCount) {
+        getLogger()->debug(__FUNCTION__ ": receive queue is full, {:d} messages overflowed so far",
+                           m_messages.overflowCount());
     }
 
     m_reception->vftable->notify(m_reception);
@@ -225,7 +224,6 @@ game::IMqNetSession* __fastcall CNetCustomPlayer::getSession(CNetCustomPlayer* t
 
 int __fastcall CNetCustomPlayer::getMessageCount(CNetCustomPlayer* thisptr, int /*%edx*/)
 {
-    std::lock_guard<std::mutex> messageGuard(thisptr->m_messagesMutex);
     return static_cast<int>(thisptr->m_messages.size());
 }
 
@@ -235,18 +233,22 @@ game::ReceiveMessageResult __fastcall CNetCustomPlayer::receiveMessage(
     std::uint32_t* idFrom,
     game::NetMessageHeader* buffer)
 {
-    std::lock_guard<std::mutex> messageGuard(thisptr->m_messagesMutex);
-
-    if (thisptr->m_messages.empty()) {
-        return game::ReceiveMessageResult::NoMessages;
+    std::uint32_t messageIdFrom;
+    auto data = thisptr->m_messages.front(&messageIdFrom);
+    if (!data) {
+        // Do not wait for the network thread if game messages are already received by the peer
+        thisptr->getService()->routeGameMessages();
+        data = thisptr->m_messages.front(&messageIdFrom);
+        if (!data) {
+            return game::ReceiveMessageResult::NoMessages;
+        }
     }
 
-    const auto& pair = thisptr->m_messages.front();
-    auto message = reinterpret_cast<const game::NetMessageHeader*>(pair.second.get());
+    auto message = reinterpret_cast<const game::NetMessageHeader*>(data->data());
 
     if (message->messageType != game::netMessageNormalType) {
         thisptr->getLogger()
-            ->debug(__FUNCTION__ ": message from 0x{:x} with unexpected type 0x{:x}", *idFrom,
+            ->debug(__FUNCTION__ ": message from 0x{:x} with unexpected type 0x{:x}", messageIdFrom,
                     message->messageType);
         return game::ReceiveMessageResult::Failure;
     }
@@ -254,11 +256,11 @@ game::ReceiveMessageResult __fastcall CNetCustomPlayer::receiveMessage(
     if (message->length >= game::netMessageMaxLength) {
         thisptr->getLogger()->debug(
             __FUNCTION__ ": message from 0x{:x} with length {:d} that exeeds maximum of {:d}",
-            *idFrom, message->length, game::netMessageMaxLength);
+            messageIdFrom, message->length, game::netMessageMaxLength);
         return game::ReceiveMessageResult::Failure;
     }
 
-    *idFrom = pair.first;
+    *idFrom = messageIdFrom;
     std::memcpy(buffer, message, message->length);
     thisptr->m_messages.pop();
 
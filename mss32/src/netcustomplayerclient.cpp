@@ -66,6 +66,7 @@ CNetCustomPlayerClient::CNetCustomPlayerClient(CNetCustomSession* session,
     this->vftable = &vftable;
     auto service = getService();
     service->addPeerCallback(&m_peerCallback);
+    service->addGameMessageCallback(&m_peerCallback);
     service->addRoomsCallback(&m_roomsCallback);
 }
 
@@ -74,6 +75,7 @@ CNetCustomPlayerClient ::~CNetCustomPlayerClient()
     getLogger()->debug(__FUNCTION__);
     auto service = getService();
     service->removeRoomsCallback(&m_roomsCallback);
+    service->removeGameMessageCallback(&m_peerCallback);
     service->removePeerCallback(&m_peerCallback);
 }
 
@@ -128,25 +130,10 @@ void CNetCustomPlayerClient::PeerCallback::onPacketReceived(DefaultMessageIDType
                                                             const SLNet::Packet* packet)
 {
     switch (type) {
-    case ID_GAME_MESSAGE: {
-        SLNet::RakNetGUID sender;
-        auto message = getMessageAndSender(packet, &sender);
-        if (sender != m_player->m_serverGuid) {
-            // Should only be a message to the server if we are hosting
-            // (since both server and client players share the same peer)
-            m_player->getLogger()
-                ->debug(__FUNCTION__ ": skipping '{:s}' from 0x{:x} (not a server)",
-                        message->messageClassName, getClientId(sender));
-            break;
-        }
-        m_player->postMessageToReceive(message, game::serverNetPlayerId);
-        break;
-    }
-
+    case ID_GAME_MESSAGE:
     case ID_GAME_MESSAGE_TO_HOST_CLIENT: {
-        auto message = reinterpret_cast<game::NetMessageHeader*>(packet->data);
-        message->messageType = game::netMessageNormalType; // TODO: any better way to do this?
-        m_player->postMessageToReceive(message, game::serverNetPlayerId);
+        // Game messages that were not routed by the peer, see CNetCustomPeer::RouteGameMessages
+        onGameMessageReceived(packet);
         break;
     }
 
@@ -170,11 +157,48 @@ void CNetCustomPlayerClient::PeerCallback::onPacketReceived(DefaultMessageIDType
     }
 }
 
+bool CNetCustomPlayerClient::PeerCallback::onGameMessageReceived(const SLNet::Packet* packet)
+{
+    switch (packet->data[0]) {
+    case ID_GAME_MESSAGE: {
+        SLNet::RakNetGUID sender;
+        auto message = getMessageAndSender(packet, &sender);
+        if (!message) {
+            return false;
+        }
+
+        if (sender != m_player->m_serverGuid) {
+            // Should only be a message to the server if we are hosting
+            // (since both server and client players share the same peer)
+            m_player->getLogger()
+                ->debug(__FUNCTION__ ": skipping '{:s}' from 0x{:x} (not a server)",
+                        message->messageClassName, getClientId(sender));
+            return false;
+        }
+        m_player->postMessageToReceive(message, game::serverNetPlayerId);
+        return true;
+    }
+
+    case ID_GAME_MESSAGE_TO_HOST_CLIENT: {
+        auto message = reinterpret_cast<game::NetMessageHeader*>(packet->data);
+        message->messageType = game::netMessageNormalType; // TODO: any better way to do this?
+        m_player->postMessageToReceive(message, game::serverNetPlayerId);
+        return true;
+    }
+    }
+
+    return false;
+}
+
 void CNetCustomPlayerClient::RoomsCallback::RoomDestroyedOnModeratorLeft_Callback(
     const SLNet::SystemAddress& senderAddress,
     SLNet::RoomDestroyedOnModeratorLeft_Notification* notification)
 {
-    // TODO: make sure that the notification only arrives for our room, otherwise check roomId
+    if (!m_player->getService()->isCurrentRoom(notification->roomId)) {
+        m_player->getLogger()->debug(__FUNCTION__ ": skipping room {:d}", notification->roomId);
+        return;
+    }
+
     m_player->getLogger()->debug(__FUNCTION__);
     auto system = m_player->getSystem();
     if (system) {
@@ -27,7 +27,6 @@
 #include "utils.h"
 #include <BitStream.h>
 #include <MessageIdentifiers.h>
-#include <algorithm>
 #include <mutex>
 #include <spdlog/spdlog.h>
 
@@ -64,6 +63,7 @@ CNetCustomPlayerServer::CNetCustomPlayerServer(CNetCustomSession* session,
 
     this->vftable = &vftable;
     getService()->addPeerCallback(&m_peerCallback);
+    getService()->addGameMessageCallback(&m_peerCallback);
     getService()->addRoomsCallback(&m_roomsCallback);
 }
 
@@ -71,6 +71,7 @@ CNetCustomPlayerServer::~CNetCustomPlayerServer()
 {
     getLogger()->debug(__FUNCTION__);
     getService()->removePeerCallback(&m_peerCallback);
+    getService()->removeGameMessageCallback(&m_peerCallback);
     getService()->removeRoomsCallback(&m_roomsCallback);
 }
 
@@ -81,8 +82,7 @@ bool CNetCustomPlayerServer::addClient(const SLNet::RakNetGUID& guid, const SLNe
 
     {
         std::lock_guard lock(m_remoteClientsMutex);
-        auto result = m_remoteClients.insert({guid, name});
-        if (!result.second) {
+        if (!m_remoteClients.add(guid, name)) {
             getLogger()
                 ->debug(__FUNCTION__ ": failed because the id 0x{:x} already exists, name = {:s}",
                         getClientId(guid), name.C_String());
@@ -100,8 +100,7 @@ bool CNetCustomPlayerServer::removeClient(const SLNet::RakNetGUID& guid)
 {
     {
         std::lock_guard lock(m_remoteClientsMutex);
-        size_t result = m_remoteClients.erase(guid);
-        if (!result) {
+        if (!m_remoteClients.remove(guid)) {
             getLogger()->debug(__FUNCTION__ ": failed because the id 0x{:x} does not exist",
                                getClientId(guid));
             return false;
@@ -116,16 +115,10 @@ bool CNetCustomPlayerServer::removeClient(const SLNet::RakNetGUID& guid)
 
 bool CNetCustomPlayerServer::removeClient(const SLNet::RakString& name)
 {
-    SLNet::RakNetGUID guid = SLNet::UNASSIGNED_RAKNET_GUID;
+    SLNet::RakNetGUID guid;
     {
         std::lock_guard lock(m_remoteClientsMutex);
-        for (auto it = m_remoteClients.begin(); it != m_remoteClients.end(); ++it) {
-            if (it->second == name) {
-                guid = it->first;
-                m_remoteClients.erase(guid);
-                break;
-            }
-        }
+        guid = m_remoteClients.remove(name);
     }
 
     if (guid == SLNet::UNASSIGNED_RAKNET_GUID) {
@@ -211,19 +204,17 @@ bool __fastcall CNetCustomPlayerServer::setAllowJoin(CNetCustomPlayerServer* thi
 CNetCustomPlayerServer::RemoteClients CNetCustomPlayerServer::getRemoteClients() const
 {
     std::lock_guard lock(m_remoteClientsMutex);
-    return m_remoteClients;
+    return m_remoteClients.getMembers();
 }
 
 SLNet::RakNetGUID CNetCustomPlayerServer::getRemoteClientGuid(std::uint32_t id) const
 {
     std::lock_guard lock(m_remoteClientsMutex);
-    auto it = std::find_if(m_remoteClients.begin(), m_remoteClients.end(),
-                           [id](const auto& client) { return getClientId(client.first) == id; });
-    if (it == m_remoteClients.end()) {
+    auto guid = m_remoteClients.findGuid(id);
+    if (guid == SLNet::UNASSIGNED_RAKNET_GUID) {
         getLogger()->debug(__FUNCTION__ ": there is no client with id 0x{:x}", id);
-        return {};
     }
-    return it->first;
+    return guid;
 }
 
 void CNetCustomPlayerServer::PeerCallback::onPacketReceived(DefaultMessageIDTypes type,
@@ -231,17 +222,10 @@ void CNetCustomPlayerServer::PeerCallback::onPacketReceived(DefaultMessageIDType
                                                             const SLNet::Packet* packet)
 {
     switch (type) {
-    case ID_GAME_MESSAGE: {
-        SLNet::RakNetGUID sender;
-        auto message = getMessageAndSender(packet, &sender);
-        m_player->postMessageToReceive(message, getClientId(sender));
-        break;
-    }
-
+    case ID_GAME_MESSAGE:
     case ID_GAME_MESSAGE_TO_HOST_SERVER: {
-        auto message = reinterpret_cast<game::NetMessageHeader*>(packet->data);
-        message->messageType = game::netMessageNormalType; // TODO: any better way to do this?
-        m_player->postMessageToReceive(message, getClientId(packet->guid));
+        // Game messages that were not routed by the peer, see CNetCustomPeer::RouteGameMessages
+        onGameMessageReceived(packet);
         break;
     }
 
@@ -259,11 +243,40 @@ void CNetCustomPlayerServer::PeerCallback::onPacketReceived(DefaultMessageIDType
     }
 }
 
+bool CNetCustomPlayerServer::PeerCallback::onGameMessageReceived(const SLNet::Packet* packet)
+{
+    switch (packet->data[0]) {
+    case ID_GAME_MESSAGE: {
+        SLNet::RakNetGUID sender;
+        auto message = getMessageAndSender(packet, &sender);
+        if (!message) {
+            return false;
+        }
+
+        m_player->postMessageToReceive(message, getClientId(sender));
+        return true;
+    }
+
+    case ID_GAME_MESSAGE_TO_HOST_SERVER: {
+        auto message = reinterpret_cast<game::NetMessageHeader*>(packet->data);
+        message->messageType = game::netMessageNormalType; // TODO: any better way to do this?
+        m_player->postMessageToReceive(message, getClientId(packet->guid));
+        return true;
+    }
+    }
+
+    return false;
+}
+
 void CNetCustomPlayerServer::RoomsCallback::RoomMemberLeftRoom_Callback(
     const SLNet::SystemAddress& /*senderAddress is the lobby*/,
     SLNet::RoomMemberLeftRoom_Notification* notification)
 {
-    // TODO: make sure that the notification only arrives for our room, otherwise check roomId
+    if (!m_player->getService()->isCurrentRoom(notification->roomId)) {
+        m_player->getLogger()->debug(__FUNCTION__ ": skipping room {:d}", notification->roomId);
+        return;
+    }
+
     m_player->getLogger()->debug(__FUNCTION__ ": member name = '{:s}'",
                                  notification->roomMember.C_String());
     m_player->removeClient(notification->roomMember);
@@ -273,7 +286,11 @@ void CNetCustomPlayerServer::RoomsCallback::RoomMemberJoinedRoom_Callback(
     const SLNet::SystemAddress& /*senderAddress is the lobby*/,
     SLNet::RoomMemberJoinedRoom_Notification* notification)
 {
-    // TODO: make sure that the notification only arrives for our room, otherwise check roomId
+    if (!m_player->getService()->isCurrentRoom(notification->roomId)) {
+        m_player->getLogger()->debug(__FUNCTION__ ": skipping room {:d}", notification->roomId);
+        return;
+    }
+
     const auto result = notification->joinedRoomResult;
     m_player->getLogger()->debug(__FUNCTION__ ": member name = '{:s}'",
                                  result->joiningMemberName.C_String());
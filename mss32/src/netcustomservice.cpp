@@ -30,6 +30,7 @@
 #include "uimanager.h"
 #include "utils.h"
 #include <MessageIdentifiers.h>
+#include <algorithm>
 #include <array>
 #include <mutex>
 #include <spdlog/spdlog.h>
@@ -63,14 +64,15 @@ CNetCustomService::CNetCustomService()
     , m_session(nullptr)
     , m_peerCallback(this)
     , m_lobbyCallback(this)
+    , m_roomsCallback(this)
 {
     spdlog::debug(__FUNCTION__);
 
     vftable = &g_vftable;
 
     // TODO: separate peers for lobby client, server and client players.
-    // TODO: process server peer packets directly in server thread.
-    // TODO: process players peer packets right inside IMqNetPlayer::ReceiveMessage.
+    // Game messages are routed to players by network thread or inside IMqNetPlayer::ReceiveMessage,
+    // see CNetCustomPeer::RouteGameMessages.
     // Replacing peer queue constant polling (WM_TIMER) with notification message for better
     // efficiency
     // createTimerEvent(&m_peerProcessEvent, this, peerProcessEventCallback, peerProcessInterval);
@@ -408,6 +410,213 @@ std::vector<CNetCustomService::ChatMessage> CNetCustomService::readChatMessages(
     return result;
 }
 
+void CNetCustomService::subscribeLobbyUpdates()
+{
+    spdlog::debug(__FUNCTION__);
+
+    // Start from scratch, the caller expects full users list and chat history
+    m_lobbyUpdates = LobbyUpdates{};
+    if (!lobbySettings().pushUpdates) {
+        // Lobby server is not known to support subscriptions, keep polling
+        return;
+    }
+
+    m_lobbyUpdates.subscribed = true;
+    requestLobbyUpdates(0);
+}
+
+void CNetCustomService::unsubscribeLobbyUpdates()
+{
+    spdlog::debug(__FUNCTION__);
+
+    if (!m_lobbyUpdates.subscribed) {
+        return;
+    }
+
+    m_lobbyUpdates = LobbyUpdates{};
+
+    SLNet::BitStream stream;
+    stream.Write(static_cast<SLNet::MessageID>(ID_LOBBY_UNSUBSCRIBE_REQUEST));
+    send(stream, getLobbyGuid(), LOW_PRIORITY);
+}
+
+bool CNetCustomService::onlineUsersSynced() const
+{
+    return m_lobbyUpdates.usersSynced;
+}
+
+const std::vector<CNetCustomService::UserInfo>& CNetCustomService::getOnlineUsers() const
+{
+    return m_lobbyUpdates.users;
+}
+
+bool CNetCustomService::chatMessagesSynced() const
+{
+    return m_lobbyUpdates.chatSynced;
+}
+
+const CNetCustomService::ChatMessagesUpdate& CNetCustomService::getChatMessagesUpdate() const
+{
+    return m_lobbyUpdates.chatUpdate;
+}
+
+void CNetCustomService::requestLobbyUpdates(std::uint32_t lastChatMessageId)
+{
+    SLNet::BitStream stream;
+    stream.Write(static_cast<SLNet::MessageID>(ID_LOBBY_SUBSCRIBE_REQUEST));
+    stream.Write(lastChatMessageId);
+    send(stream, getLobbyGuid(), LOW_PRIORITY);
+}
+
+void CNetCustomService::resyncLobbyUpdates()
+{
+    // Wait for the reply, gaps detected meanwhile are covered by it
+    if (m_lobbyUpdates.resyncRequested) {
+        return;
+    }
+
+    spdlog::debug(__FUNCTION__ ": lobby update is missed, last chat message id {:d}",
+                  m_lobbyUpdates.lastChatMessageId);
+
+    m_lobbyUpdates.resyncRequested = true;
+    m_lobbyUpdates.usersSynced = false;
+    requestLobbyUpdates(m_lobbyUpdates.lastChatMessageId);
+}
+
+void CNetCustomService::readOnlineUsersSnapshot(const SLNet::Packet* packet)
+{
+    using namespace SLNet;
+
+    BitStream stream{packet->data, packet->length, false};
+    stream.IgnoreBytes(sizeof(MessageID));
+
+    std::uint32_t sequence;
+    if (!stream.Read(sequence)) {
+        spdlog::debug(__FUNCTION__ ": failed to read online users sequence");
+        return;
+    }
+
+    // Snapshot payload is the same as ID_LOBBY_GET_ONLINE_USERS_RESPONSE after the sequence
+    std::uint32_t count;
+    if (!stream.Read(count)) {
+        spdlog::debug(__FUNCTION__ ": failed to read online users count");
+        return;
+    }
+
+    std::vector<UserInfo> users;
+    users.reserve(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        RakNetGUID guid;
+        RakString name;
+        if (!stream.Read(guid) || !stream.Read(name)) {
+            spdlog::debug(__FUNCTION__ ": failed to read online user");
+            return;
+        }
+
+        users.push_back({guid, name});
+    }
+
+    m_lobbyUpdates.users = std::move(users);
+    m_lobbyUpdates.usersSequence = sequence;
+    m_lobbyUpdates.usersSynced = true;
+    m_lobbyUpdates.resyncRequested = false;
+}
+
+void CNetCustomService::readOnlineUsersDelta(const SLNet::Packet* packet)
+{
+    using namespace SLNet;
+
+    if (!m_lobbyUpdates.usersSynced) {
+        // Snapshot is on its way, it already includes this change
+        return;
+    }
+
+    BitStream stream{packet->data, packet->length, false};
+    stream.IgnoreBytes(sizeof(MessageID));
+
+    std::uint32_t sequence;
+    bool joined;
+    RakNetGUID guid;
+    if (!stream.Read(sequence) || !stream.Read(joined) || !stream.Read(guid)) {
+        spdlog::debug(__FUNCTION__ ": failed to read online users delta");
+        return;
+    }
+
+    if (sequence != m_lobbyUpdates.usersSequence + 1) {
+        resyncLobbyUpdates();
+        return;
+    }
+
+    auto& users = m_lobbyUpdates.users;
+    auto it = std::find_if(users.begin(), users.end(),
+                           [&guid](const UserInfo& user) { return user.guid == guid; });
+
+    if (joined) {
+        RakString name;
+        if (!stream.Read(name)) {
+            spdlog::debug(__FUNCTION__ ": failed to read online user name");
+            return;
+        }
+
+        if (it == users.end()) {
+            users.push_back({guid, name});
+        } else {
+            it->name = name;
+        }
+    } else if (it != users.end()) {
+        users.erase(it);
+    }
+
+    m_lobbyUpdates.usersSequence = sequence;
+}
+
+void CNetCustomService::readChatMessagesUpdate(const SLNet::Packet* packet)
+{
+    using namespace SLNet;
+
+    auto& chatUpdate = m_lobbyUpdates.chatUpdate;
+    chatUpdate.messages.clear();
+    chatUpdate.history = false;
+
+    BitStream stream{packet->data, packet->length, false};
+    stream.IgnoreBytes(sizeof(MessageID));
+
+    bool subscribeReply;
+    std::uint32_t count;
+    if (!stream.Read(subscribeReply) || !stream.Read(count)) {
+        spdlog::debug(__FUNCTION__ ": failed to read chat messages update");
+        return;
+    }
+
+    // First reply to subscription is the history, resync replies only fill the gap
+    chatUpdate.history = subscribeReply && !m_lobbyUpdates.chatSynced;
+    m_lobbyUpdates.chatSynced = true;
+
+    for (std::uint32_t i = 0; i < count; ++i) {
+        std::uint32_t id;
+        RakString sender;
+        RakString text;
+        if (!stream.Read(id) || !stream.Read(sender) || !stream.Read(text)) {
+            spdlog::debug(__FUNCTION__ ": failed to read chat message");
+            return;
+        }
+
+        auto& lastId = m_lobbyUpdates.lastChatMessageId;
+        if (id <= lastId) {
+            continue;
+        }
+
+        // Server history may be trimmed, so replies are accepted as is
+        if (!subscribeReply && id != lastId + 1) {
+            resyncLobbyUpdates();
+            return;
+        }
+
+        lastId = id;
+        chatUpdate.messages.push_back({sender, text});
+    }
+}
+
 void CNetCustomService::setTemplateInfo(const std::string& name)
 {
     m_templateName = name;
@@ -563,6 +772,11 @@ bool CNetCustomService::changeRoomPublicSlots(unsigned int publicSlots)
     return true;
 }
 
+bool CNetCustomService::isCurrentRoom(SLNet::RoomID roomId) const
+{
+    return m_roomId == roomId;
+}
+
 void CNetCustomService::addPeerCallback(NetPeerCallback* callback)
 {
     spdlog::debug(__FUNCTION__);
@@ -583,6 +797,25 @@ void CNetCustomService::removePeerCallback(NetPeerCallback* callback)
                           m_peerCallbacks.end());
 }
 
+void CNetCustomService::addGameMessageCallback(NetGameMessageCallback* callback)
+{
+    spdlog::debug(__FUNCTION__);
+
+    m_peer->AddGameMessageCallback(callback);
+}
+
+void CNetCustomService::removeGameMessageCallback(NetGameMessageCallback* callback)
+{
+    spdlog::debug(__FUNCTION__);
+
+    m_peer->RemoveGameMessageCallback(callback);
+}
+
+void CNetCustomService::routeGameMessages() const
+{
+    m_peer->RouteGameMessages();
+}
+
 void CNetCustomService::addLobbyCallback(SLNet::Lobby2Callbacks* callback)
 {
     spdlog::debug(__FUNCTION__);
@@ -694,8 +927,15 @@ void __fastcall CNetCustomService::peerProcessEventCallback(const CNetCustomServ
         return;
     }
 
-    processing = true;
     auto peer = service->m_peer;
+    if (!peer->TryBeginReceive()) {
+        // Game messages are being routed, network thread will notify about the rest of packets
+        spdlog::debug(__FUNCTION__ ": packets are being routed, postponing processing");
+        peer->ResetPacketNotification();
+        return;
+    }
+
+    processing = true;
     for (auto packet = peer->Receive(); packet != nullptr;
          peer->DeallocatePacket(packet), packet = peer->Receive()) {
 
@@ -706,6 +946,7 @@ void __fastcall CNetCustomService::peerProcessEventCallback(const CNetCustomServ
         }
     }
     processing = false;
+    peer->EndReceive();
     peer->ResetPacketNotification();
 }
 
@@ -804,10 +1045,14 @@ void CNetCustomService::PeerCallback::onPacketReceived(DefaultMessageIDTypes typ
     case ID_DISCONNECTION_NOTIFICATION:
         spdlog::debug(__FUNCTION__ ": server was shut down");
         m_service->m_connected = false;
+        m_service->m_lobbyUpdates = LobbyUpdates{};
+        m_service->m_roomId.reset();
         break;
     case ID_CONNECTION_LOST:
         spdlog::debug(__FUNCTION__ ": connection with server is lost");
         m_service->m_connected = false;
+        m_service->m_lobbyUpdates = LobbyUpdates{};
+        m_service->m_roomId.reset();
         break;
     case ID_LOBBY2_SERVER_ERROR:
         spdlog::debug(__FUNCTION__ ": lobby server error");
@@ -815,6 +1060,15 @@ void CNetCustomService::PeerCallback::onPacketReceived(DefaultMessageIDTypes typ
     case ID_ROOMS_EXECUTE_FUNC:
         spdlog::debug(__FUNCTION__ ": room function executed");
         break;
+    case ID_LOBBY_ONLINE_USERS_SNAPSHOT:
+        m_service->readOnlineUsersSnapshot(packet);
+        break;
+    case ID_LOBBY_ONLINE_USERS_DELTA:
+        m_service->readOnlineUsersDelta(packet);
+        break;
+    case ID_LOBBY_CHAT_MESSAGES_UPDATE:
+        m_service->readChatMessagesUpdate(packet);
+        break;
     default:
         // Log user messages explicitly to avoid cluttering the log
         if (type < ID_USER_PACKET_ENUM) {
@@ -874,6 +1128,9 @@ void CNetCustomService::RoomsCallback::CreateRoom_Callback(
 {
     ExecuteDefaultResult("CreateRoom", callResult->resultCode, callResult->roomId,
                          &callResult->roomDescriptor);
+    if (callResult->resultCode == SLNet::REC_SUCCESS) {
+        m_service->m_roomId = callResult->roomId;
+    }
 }
 
 void CNetCustomService::RoomsCallback::EnterRoom_Callback(const SLNet::SystemAddress& senderAddress,
@@ -881,6 +1138,9 @@ void CNetCustomService::RoomsCallback::EnterRoom_Callback(const SLNet::SystemAdd
 {
     ExecuteDefaultResult("EnterRoom", callResult->resultCode, callResult->roomId,
                          &callResult->joinedRoomResult.roomDescriptor);
+    if (callResult->resultCode == SLNet::REC_SUCCESS) {
+        m_service->m_roomId = callResult->roomId;
+    }
 }
 
 void CNetCustomService::RoomsCallback::LeaveRoom_Callback(const SLNet::SystemAddress& senderAddress,
@@ -888,6 +1148,9 @@ void CNetCustomService::RoomsCallback::LeaveRoom_Callback(const SLNet::SystemAdd
 {
     auto roomId = callResult->removeUserResult.roomId;
     ExecuteDefaultResult("LeaveRoom", callResult->resultCode, roomId);
+    if (callResult->resultCode == SLNet::REC_SUCCESS && m_service->isCurrentRoom(roomId)) {
+        m_service->m_roomId.reset();
+    }
 }
 
 void CNetCustomService::RoomsCallback::RoomMemberLeftRoom_Callback(
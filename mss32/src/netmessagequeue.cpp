@@ -0,0 +1,140 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "netmessagequeue.h"
+
+namespace hooks {
+
+NetMessageQueue::NetMessageQueue()
+    : m_enqueuePosition{0}
+    , m_dequeuePosition{0}
+    , m_overflowSize{0}
+    , m_overflowCount{0}
+    , m_frontInOverflow{false}
+{
+    // Slot sequence equal to enqueue position means the slot is free for it
+    for (std::size_t i = 0; i < capacity; ++i) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+void NetMessageQueue::push(std::uint32_t idFrom, const unsigned char* data, std::size_t length)
+{
+    // Messages that come after overflowed ones must wait for them
+    if (m_overflowSize.load(std::memory_order_acquire) == 0 && pushToRing(idFrom, data, length)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_overflowMutex);
+    m_overflow.push({idFrom, std::vector<unsigned char>(data, data + length)});
+    m_overflowSize.fetch_add(1, std::memory_order_release);
+    m_overflowCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+const std::vector<unsigned char>* NetMessageQueue::front(std::uint32_t* idFrom)
+{
+    auto& slot = m_slots[m_dequeuePosition & (capacity - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) == m_dequeuePosition + 1) {
+        m_frontInOverflow = false;
+        *idFrom = slot.idFrom;
+        return &slot.data;
+    }
+
+    // Ring messages are older than overflowed ones of the same producer,
+    // wait for the ones that are still being written
+    if (m_enqueuePosition.load(std::memory_order_acquire) != m_dequeuePosition
+        || m_overflowSize.load(std::memory_order_acquire) == 0) {
+        return nullptr;
+    }
+
+    // Overflow front is only removed by the consumer, so it stays valid after unlock
+    std::lock_guard<std::mutex> lock(m_overflowMutex);
+    m_frontInOverflow = true;
+    *idFrom = m_overflow.front().idFrom;
+    return &m_overflow.front().data;
+}
+
+void NetMessageQueue::pop()
+{
+    if (!m_frontInOverflow) {
+        auto& slot = m_slots[m_dequeuePosition & (capacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePosition + 1) {
+            return;
+        }
+
+        if (slot.data.capacity() > maxReusedBufferSize) {
+            std::vector<unsigned char>().swap(slot.data);
+        }
+
+        // Slot is free for the producer that comes a whole ring later
+        slot.sequence.store(m_dequeuePosition + capacity, std::memory_order_release);
+        ++m_dequeuePosition;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_overflowMutex);
+    if (!m_overflow.empty()) {
+        m_overflow.pop();
+        m_overflowSize.fetch_sub(1, std::memory_order_release);
+    }
+
+    m_frontInOverflow = false;
+}
+
+std::size_t NetMessageQueue::size() const
+{
+    const auto enqueued = m_enqueuePosition.load(std::memory_order_acquire);
+    // Producers may have reserved slots that are not filled yet
+    const auto inRing = enqueued > m_dequeuePosition ? enqueued - m_dequeuePosition : 0;
+    return inRing + m_overflowSize.load(std::memory_order_acquire);
+}
+
+std::uint32_t NetMessageQueue::overflowCount() const
+{
+    return m_overflowCount.load(std::memory_order_relaxed);
+}
+
+bool NetMessageQueue::pushToRing(std::uint32_t idFrom,
+                                 const unsigned char* data,
+                                 std::size_t length)
+{
+    auto position = m_enqueuePosition.load(std::memory_order_relaxed);
+    for (;;) {
+        auto& slot = m_slots[position & (capacity - 1)];
+        const auto sequence = slot.sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<std::ptrdiff_t>(sequence)
+                                - static_cast<std::ptrdiff_t>(position);
+        if (difference == 0) {
+            if (m_enqueuePosition.compare_exchange_weak(position, position + 1,
+                                                        std::memory_order_relaxed)) {
+                slot.idFrom = idFrom;
+                slot.data.assign(data, data + length);
+                slot.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (difference < 0) {
+            // Slot still holds a message from the previous round, ring is full
+            return false;
+        } else {
+            position = m_enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+} // namespace hooks
@@ -0,0 +1,108 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pendingstackmoves.h"
+#include "gameutils.h"
+#include "midgardid.h"
+#include "midstack.h"
+#include "mqpoint.h"
+#include "utils.h"
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <spdlog/spdlog.h>
+
+namespace hooks {
+
+struct PendingStackMove
+{
+    std::uint32_t sequence;
+    game::CMidgardID stackId;
+    game::CMqPoint endPosition;
+    std::chrono::steady_clock::time_point sendTime;
+};
+
+struct StackMoveStatistics
+{
+    std::uint32_t confirmed;
+    std::uint32_t interrupted;
+    long long totalMs;
+    long long maxMs;
+};
+
+// Stack moves are sent and confirmed in the main thread only
+static std::deque<PendingStackMove> pendingMoves;
+static std::uint32_t nextSequence{1};
+static StackMoveStatistics statistics{};
+
+void addPendingStackMove(const game::CMidgardID& stackId, const game::CMqPoint& endPosition)
+{
+    const auto sequence = nextSequence++;
+    pendingMoves.push_back({sequence, stackId, endPosition, std::chrono::steady_clock::now()});
+
+    spdlog::debug(__FUNCTION__ ": move {:d} of stack {:s} to ({:d}, {:d}), {:d} pending",
+                  sequence, idToString(&stackId), endPosition.x, endPosition.y,
+                  pendingMoves.size());
+}
+
+bool confirmPendingStackMove(const game::IMidgardObjectMap* objectMap)
+{
+    using namespace std::chrono;
+
+    if (pendingMoves.empty()) {
+        // Confirmation of a move sent before the lock was reset, nothing to wait for anyway
+        spdlog::debug(__FUNCTION__ ": no pending stack moves");
+        return true;
+    }
+
+    const auto move{pendingMoves.front()};
+    pendingMoves.pop_front();
+
+    const auto elapsedMs = duration_cast<milliseconds>(steady_clock::now() - move.sendTime).count();
+    ++statistics.confirmed;
+    statistics.totalMs += elapsedMs;
+    if (elapsedMs > statistics.maxMs) {
+        statistics.maxMs = elapsedMs;
+    }
+
+    // Stack is missing if it was destroyed in battle that the move started
+    const auto stack = getStack(objectMap, &move.stackId);
+    if (stack
+        && (stack->position.x != move.endPosition.x || stack->position.y != move.endPosition.y)) {
+        ++statistics.interrupted;
+        spdlog::debug(__FUNCTION__ ": move {:d} stopped at ({:d}, {:d}) instead of ({:d}, {:d})",
+                      move.sequence, stack->position.x, stack->position.y, move.endPosition.x,
+                      move.endPosition.y);
+    }
+
+    spdlog::debug(__FUNCTION__ ": move {:d} confirmed in {:d} ms. Moves confirmed: {:d}, "
+                  "interrupted: {:d}, average {:d} ms, max {:d} ms",
+                  move.sequence, elapsedMs, statistics.confirmed, statistics.interrupted,
+                  statistics.totalMs / statistics.confirmed, statistics.maxMs);
+
+    return pendingMoves.empty();
+}
+
+void clearPendingStackMoves()
+{
+    pendingMoves.clear();
+    statistics = StackMoveStatistics{};
+}
+
+} // namespace hooks
@@ -21,6 +21,7 @@
 #include "midclient.h"
 #include "midgard.h"
 #include "midobjectlock.h"
+#include "pendingstackmoves.h"
 #include "phasegame.h"
 #include "stackmovemsg.h"
 #include <spdlog/spdlog.h>
@@ -65,6 +66,8 @@ void __fastcall phaseGameSendStackMoveMsgHooked(
         __FUNCTION__ ": CMidObjectLock::movingStack set to true, pendingNetworkUpdates incremented to {:d}",
         data->midObjectLock->pendingNetworkUpdates);
 
+    addPendingStackMove(*stackId, *endPosition);
+
     CStackMoveMsg message;
     stackMoveMsgApi.constructor2(&message, stackId, movementPath, startPosition, endPosition);
 
@@ -34,6 +34,7 @@
 #include "playerview.h"
 #include "racecategory.h"
 #include "racetype.h"
+#include "scriptregistry.h"
 #include "scripts.h"
 #include "settings.h"
 #include "utils.h"
@@ -235,12 +236,9 @@ game::Bank* __stdcall computePlayerDailyIncomeHooked(game::Bank* income,
     BankApi::get().set(income, CurrencyType::Gold, std::clamp(totalGoldIncome, 0, 9999));
     BankApi::get().set(income, manaType, std::clamp(totalManaIncome, 0, 9999));
 
-    static std::optional<sol::environment> env;
-    static std::optional<sol::function> getIncome;
-    const auto path{scriptsFolder() / "income.lua"};
-    if (!env && !getIncome) {
-        getIncome = getScriptFunction(path, "getTurnIncome", env, false, true);
-    }
+    const auto script{getScriptRegistry().getFunction(scriptsFolder() / "income.lua",
+                                                     "getTurnIncome")};
+    const auto& getIncome{script.function};
     if (getIncome) {
         bindings::PlayerView playerView{player, objectMap};
         bindings::CurrencyView incomeView{*income};
@@ -0,0 +1,167 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "randomstream.h"
+#include <memory>
+#include <sol/sol.hpp>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace hooks {
+
+// Server and client threads load their own scenario maps, so each keeps its own seed
+static thread_local std::uint64_t randomSeed{0};
+// Incremented on each reseed, so streams restart even if the seed is the same
+static thread_local std::uint32_t randomSeedGeneration{0};
+
+static std::uint64_t hashName(const std::string& name)
+{
+    // FNV-1a
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    for (unsigned char ch : name) {
+        hash ^= ch;
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+static std::uint64_t mix(std::uint64_t value)
+{
+    // SplitMix64 finalizer
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+    return value ^ (value >> 31);
+}
+
+static std::array<std::uint32_t, 4> philox4x32(std::array<std::uint32_t, 4> counter,
+                                               std::array<std::uint32_t, 2> key)
+{
+    static constexpr std::uint32_t multiplier0 = 0xd2511f53;
+    static constexpr std::uint32_t multiplier1 = 0xcd9e8d57;
+    static constexpr std::uint32_t weyl0 = 0x9e3779b9;
+    static constexpr std::uint32_t weyl1 = 0xbb67ae85;
+
+    for (int round = 0; round < 10; ++round) {
+        const std::uint64_t product0 = static_cast<std::uint64_t>(multiplier0) * counter[0];
+        const std::uint64_t product1 = static_cast<std::uint64_t>(multiplier1) * counter[2];
+
+        counter = {static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+                   static_cast<std::uint32_t>(product1),
+                   static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+                   static_cast<std::uint32_t>(product0)};
+
+        key[0] += weyl0;
+        key[1] += weyl1;
+    }
+
+    return counter;
+}
+
+RandomStream::RandomStream(const std::string& name)
+    : m_nameHash{hashName(name)}
+    // Differs from any generation, so the key is computed on the first use
+    , m_seedGeneration{randomSeedGeneration - 1}
+    , m_key{}
+    , m_counter{0}
+    , m_block{}
+    , m_blockIndex{0}
+{ }
+
+void RandomStream::update()
+{
+    const auto generation = randomSeedGeneration;
+    if (generation == m_seedGeneration) {
+        return;
+    }
+
+    const auto key = mix(randomSeed ^ mix(m_nameHash));
+    m_seedGeneration = generation;
+    m_key = {static_cast<std::uint32_t>(key), static_cast<std::uint32_t>(key >> 32)};
+    m_counter = 0;
+    m_blockIndex = m_block.size();
+}
+
+std::uint32_t RandomStream::next()
+{
+    update();
+
+    if (m_blockIndex == m_block.size()) {
+        m_block = philox4x32({static_cast<std::uint32_t>(m_counter),
+                              static_cast<std::uint32_t>(m_counter >> 32), 0, 0},
+                             m_key);
+        ++m_counter;
+        m_blockIndex = 0;
+    }
+
+    return m_block[m_blockIndex++];
+}
+
+int RandomStream::getInt(int min, int max)
+{
+    if (min > max) {
+        throw std::invalid_argument("interval is empty");
+    }
+
+    const std::uint64_t range = static_cast<std::uint64_t>(static_cast<std::int64_t>(max) - min)
+                                + 1;
+
+    // Lemire's method, rejects the values that would make some numbers more likely
+    std::uint64_t product = next() * range;
+    auto low = static_cast<std::uint32_t>(product);
+    if (low < range) {
+        const auto threshold = static_cast<std::uint32_t>((0x100000000ull - range) % range);
+        while (low < threshold) {
+            product = next() * range;
+            low = static_cast<std::uint32_t>(product);
+        }
+    }
+
+    return static_cast<int>(min + static_cast<std::int64_t>(product >> 32));
+}
+
+void setRandomSeed(std::uint64_t seed)
+{
+    randomSeed = seed;
+    ++randomSeedGeneration;
+}
+
+RandomStream& getRandomStream(const std::string& name)
+{
+    // Streams are never removed, Lua environments keep references to them
+    thread_local std::unordered_map<std::string, std::unique_ptr<RandomStream>> streams;
+
+    auto& stream = streams[name];
+    if (!stream) {
+        stream = std::make_unique<RandomStream>(name);
+    }
+
+    return *stream;
+}
+
+void bindRandomStreams(sol::state& lua)
+{
+    auto stream = lua.new_usertype<RandomStream>("RandomStream", sol::no_constructor);
+    stream["int"] = &RandomStream::getInt;
+
+    lua.set_function("getRandomStream",
+                     [](const std::string& name) { return &getRandomStream(name); });
+}
+
+} // namespace hooks
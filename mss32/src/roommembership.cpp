@@ -0,0 +1,99 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "roommembership.h"
+#include <spdlog/spdlog.h>
+
+namespace hooks {
+
+static std::uint32_t getClientId(const SLNet::RakNetGUID& guid)
+{
+    return SLNet::RakNetGUID::ToUint32(guid);
+}
+
+bool RoomMembership::add(const SLNet::RakNetGUID& guid, const SLNet::RakString& name)
+{
+    if (!m_members.insert({guid, name}).second) {
+        return false;
+    }
+
+    // Client ids are folded from 64-bit guids and can collide,
+    // keep the member that has the id first, the game can not tell them apart anyway
+    const auto clientId{getClientId(guid)};
+    const auto [it, inserted] = m_guidsByClientId.insert({clientId, guid});
+    if (!inserted) {
+        spdlog::error("Room member 0x{:x} has the same client id 0x{:x} as member 0x{:x}",
+                      guid.g, clientId, it->second.g);
+    }
+
+    return true;
+}
+
+bool RoomMembership::remove(const SLNet::RakNetGUID& guid)
+{
+    if (!m_members.erase(guid)) {
+        return false;
+    }
+
+    const auto clientId{getClientId(guid)};
+    auto it = m_guidsByClientId.find(clientId);
+    if (it == m_guidsByClientId.end() || it->second != guid) {
+        // Client id belongs to another member
+        return true;
+    }
+
+    m_guidsByClientId.erase(it);
+
+    // Give the client id to the remaining member that collided with the removed one, if any
+    for (const auto& member : m_members) {
+        if (getClientId(member.first) == clientId) {
+            m_guidsByClientId[clientId] = member.first;
+            break;
+        }
+    }
+
+    return true;
+}
+
+SLNet::RakNetGUID RoomMembership::remove(const SLNet::RakString& name)
+{
+    // Members leave by name only when the lobby server reports it, no need to index names
+    for (const auto& [guid, memberName] : m_members) {
+        if (memberName == name) {
+            const auto result{guid};
+            remove(result);
+            return result;
+        }
+    }
+
+    return SLNet::UNASSIGNED_RAKNET_GUID;
+}
+
+SLNet::RakNetGUID RoomMembership::findGuid(std::uint32_t clientId) const
+{
+    auto it = m_guidsByClientId.find(clientId);
+    return it != m_guidsByClientId.end() ? it->second : SLNet::UNASSIGNED_RAKNET_GUID;
+}
+
+const RoomMembership::Members& RoomMembership::getMembers() const
+{
+    return m_members;
+}
+
+} // namespace hooks
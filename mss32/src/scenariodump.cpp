@@ -0,0 +1,157 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "scenariodump.h"
+#include "gameutils.h"
+#include "midscenvariables.h"
+#include "midstack.h"
+#include "midunit.h"
+#include "modifierutils.h"
+#include "scenarioinfo.h"
+#include "ummodifier.h"
+#include "unitutils.h"
+#include "usunitimpl.h"
+#include "utils.h"
+#include <fmt/format.h>
+#include <fstream>
+#include <map>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <vector>
+
+namespace hooks {
+
+using ObjectLines = std::vector<std::string>;
+// Sorted by id, so object order does not depend on the order objects were created
+using DumpLines = std::map<std::string /* object id */, ObjectLines>;
+
+static std::string idsToString(const game::IdVector& ids)
+{
+    std::string result;
+    for (auto it = ids.bgn; it != ids.end; ++it) {
+        if (!result.empty()) {
+            result += ',';
+        }
+
+        result += idToString(it);
+    }
+
+    return result.empty() ? "-" : result;
+}
+
+static void dumpUnit(const game::CMidUnit* unit, ObjectLines& lines)
+{
+    using namespace game;
+
+    auto unitImpl = unit->unitImpl ? getUnitImpl(unit->unitImpl) : nullptr;
+    lines.push_back(fmt::format("impl {:s}", unitImpl ? idToString(&unitImpl->id) : "-"));
+    lines.push_back(fmt::format("name {:s}", unit->name.string ? unit->name.string : ""));
+    lines.push_back(fmt::format("hp {:d}", unit->currentHp));
+    lines.push_back(fmt::format("xp {:d}", unit->currentXp));
+    lines.push_back(fmt::format("transformed {:d}", (int)unit->transformed));
+
+    // From the last applied modifier to the first one
+    std::string modifiers;
+    for (auto curr = unit->unitImpl; curr;) {
+        auto modifier = castUnitToUmModifier(curr);
+        if (!modifier) {
+            break;
+        }
+
+        if (!modifiers.empty()) {
+            modifiers += ',';
+        }
+
+        modifiers += idToString(&modifier->data->modifierId);
+        curr = modifier->data->prev;
+    }
+
+    lines.push_back(fmt::format("modifiers {:s}", modifiers.empty() ? "-" : modifiers));
+}
+
+static void dumpStack(const game::CMidStack* stack, ObjectLines& lines)
+{
+    using namespace game;
+
+    lines.push_back(fmt::format("owner {:s}", idToString(&stack->ownerId)));
+    lines.push_back(fmt::format("leader {:s}", idToString(&stack->leaderId)));
+    lines.push_back(fmt::format("position {:d},{:d}", stack->position.x, stack->position.y));
+    lines.push_back(fmt::format("inside {:s}", idToString(&stack->insideId)));
+    lines.push_back(fmt::format("movement {:d}", (int)stack->movement));
+    lines.push_back(fmt::format("order {:d}", (int)stack->order.id));
+    lines.push_back(fmt::format("units {:s}", idsToString(stack->group.units)));
+    lines.push_back(fmt::format("items {:s}", idsToString(stack->inventory.items)));
+}
+
+bool dumpScenario(const game::IMidgardObjectMap* objectMap, const std::filesystem::path& fileName)
+{
+    using namespace game;
+
+    DumpLines dump;
+
+    forEachScenarioObject(objectMap, IdType::Unit, [&dump](const IMidScenarioObject* obj) {
+        dumpUnit(static_cast<const CMidUnit*>(obj), dump[idToString(&obj->id)]);
+    });
+
+    forEachScenarioObject(objectMap, IdType::Stack, [&dump](const IMidScenarioObject* obj) {
+        dumpStack(static_cast<const CMidStack*>(obj), dump[idToString(&obj->id)]);
+    });
+
+    std::ofstream stream{fileName, std::ios_base::trunc};
+    if (!stream) {
+        return false;
+    }
+
+    if (auto info = getScenarioInfo(objectMap)) {
+        stream << "scenario turn " << info->currentTurn << '\n';
+    }
+
+    for (const auto& [id, lines] : dump) {
+        for (const auto& line : lines) {
+            stream << id << ' ' << line << '\n';
+        }
+    }
+
+    if (auto variables = getScenarioVariables(objectMap)) {
+        for (const auto& pair : variables->variables) {
+            stream << "variable " << pair.first << ' ' << pair.second.name << ' '
+                   << pair.second.value << '\n';
+        }
+    }
+
+    return static_cast<bool>(stream);
+}
+
+void dumpScenario(const game::IMidgardObjectMap* objectMap)
+{
+    std::ofstream stream;
+    const auto path{
+        createTimestampedFile(stream, gameFolder() / "ScenarioDumps", "scenario", "txt", false)};
+    // Created file reserves the unique name, it is written anew by dumpScenario
+    stream.close();
+
+    if (!dumpScenario(objectMap, path)) {
+        spdlog::error("Could not write scenario dump '{:s}'", path.string());
+        return;
+    }
+
+    spdlog::debug("Scenario dumped to '{:s}'", path.string());
+}
+
+} // namespace hooks
@@ -0,0 +1,188 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "scriptlog.h"
+#include "settings.h"
+#include "utils.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <spdlog/spdlog.h>
+#include <utility>
+
+namespace hooks {
+
+static const char logContextKey[] = "mss32ScriptLog";
+
+/** Shared by 'log' tables of a Lua state, used only by the thread of the state. */
+struct ScriptLogContext
+{
+    std::shared_ptr<spdlog::logger> logger;
+    spdlog::level::level_enum level;
+    std::uint32_t rateLimit;
+    std::chrono::steady_clock::time_point windowStart;
+    std::uint32_t windowMessages;
+    std::uint32_t droppedMessages;
+};
+
+static spdlog::level::level_enum getLevel(const std::string& name,
+                                          spdlog::level::level_enum def)
+{
+    if (name.empty()) {
+        return def;
+    }
+
+    const auto level = spdlog::level::from_str(name);
+    // Unknown names are also converted to 'off'
+    if (level == spdlog::level::off && name != "off") {
+        spdlog::warn("Unknown script log level '{:s}', '{:s}' is used instead", name,
+                     spdlog::level::to_string_view(def));
+        return def;
+    }
+
+    return level;
+}
+
+static void write(ScriptLogContext& context,
+                  spdlog::level::level_enum level,
+                  const std::string& message)
+{
+    if (context.rateLimit && level < spdlog::level::err) {
+        const auto now{std::chrono::steady_clock::now()};
+        if (now - context.windowStart >= std::chrono::seconds{1}) {
+            if (context.droppedMessages) {
+                context.logger->warn("{:d} messages dropped due to rate limit",
+                                     context.droppedMessages);
+            }
+
+            context.windowStart = now;
+            context.windowMessages = 0;
+            context.droppedMessages = 0;
+        }
+
+        if (++context.windowMessages > context.rateLimit) {
+            ++context.droppedMessages;
+            return;
+        }
+    }
+
+    context.logger->log(level, message);
+}
+
+static sol::object createLogFunction(sol::state& lua,
+                                     const std::shared_ptr<ScriptLogContext>& context,
+                                     spdlog::level::level_enum level,
+                                     spdlog::level::level_enum minLevel,
+                                     bool method)
+{
+    if (level < minLevel) {
+        return sol::make_object(lua, [](sol::variadic_args) {});
+    }
+
+    if (method) {
+        // Called as 'log(message)' with the table as the first argument
+        return sol::make_object(lua, [context, level](sol::table, const std::string& message) {
+            write(*context, level, message);
+        });
+    }
+
+    return sol::make_object(lua, [context, level](const std::string& message) {
+        write(*context, level, message);
+    });
+}
+
+static sol::table createLogTable(sol::state& lua,
+                                 const std::shared_ptr<ScriptLogContext>& context,
+                                 spdlog::level::level_enum minLevel)
+{
+    using namespace spdlog::level;
+
+    static const std::array<std::pair<const char*, level_enum>, 5> levels{{
+        {"trace", trace},
+        {"debug", debug},
+        {"info", info},
+        {"warn", warn},
+        {"error", err},
+    }};
+
+    auto table = lua.create_table();
+    for (const auto& [name, level] : levels) {
+        table[name] = createLogFunction(lua, context, level, minLevel, false);
+    }
+
+    auto metatable = lua.create_table();
+    metatable[sol::meta_function::call] = createLogFunction(lua, context, debug, minLevel, true);
+    table[sol::metatable_key] = metatable;
+    return table;
+}
+
+void bindScriptLog(sol::state& lua, std::shared_ptr<spdlog::logger> logger)
+{
+    const auto& debug = gameSettings().debug;
+    const auto defaultLevel = gameSettings().debugMode ? spdlog::level::trace
+                                                       : spdlog::level::info;
+
+    auto context = std::make_shared<ScriptLogContext>();
+    context->logger = std::move(logger);
+    context->level = getLevel(debug.scriptLogLevel, defaultLevel);
+    context->rateLimit = debug.scriptLogRateLimit;
+    context->windowStart = std::chrono::steady_clock::now();
+
+    lua.registry()[logContextKey] = context;
+    lua["log"] = createLogTable(lua, context, context->level);
+}
+
+static std::string toLowerGeneric(const std::filesystem::path& path)
+{
+    auto result{path.generic_string()};
+    std::transform(result.begin(), result.end(), result.begin(), [](unsigned char ch) {
+        return static_cast<char>(std::tolower(ch));
+    });
+    return result;
+}
+
+sol::object createScriptLog(sol::state& lua, const std::string& chunkName)
+{
+    const auto& levels = gameSettings().debug.scriptLogLevels;
+    if (levels.empty() || chunkName.empty() || chunkName[0] != '@') {
+        return sol::nil;
+    }
+
+    const sol::object contextObject = lua.registry()[logContextKey];
+    if (contextObject.get_type() != sol::type::userdata) {
+        return sol::nil;
+    }
+
+    const auto context = contextObject.as<std::shared_ptr<ScriptLogContext>>();
+
+    // Paths are compared relative to the scripts folder and case insensitive like on Windows
+    const std::filesystem::path path{chunkName.substr(1)};
+    const auto relative{toLowerGeneric(path.lexically_relative(scriptsFolder()))};
+    for (const auto& [scriptPath, level] : levels) {
+        if (toLowerGeneric(scriptPath) == relative) {
+            return createLogTable(lua, context, getLevel(level, context->level));
+        }
+    }
+
+    return sol::nil;
+}
+
+} // namespace hooks
@@ -0,0 +1,391 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "scriptmodules.h"
+#include "utils.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <lua.hpp>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hooks {
+
+struct ModuleTemplate
+{
+    /**
+     * False if the template can not be indexed and is probed on each search instead.
+     * Only templates inside of the scripts folder are indexed, so the game folder is never
+     * walked recursively.
+     */
+    bool indexed;
+    /** Lowercase module names, file names are case insensitive on Windows. */
+    std::unordered_map<std::string, std::filesystem::path> modules;
+};
+
+struct CompiledModule
+{
+    std::filesystem::file_time_type writeTime;
+    std::shared_ptr<const std::string> bytecode;
+};
+
+// Shared by Lua states of all threads.
+// Indexed by template rather than by 'package.path', scripts can append their own templates.
+static std::map<std::string /* pattern */, ModuleTemplate> moduleTemplates;
+// Modules already checked for ambiguity
+static std::unordered_map<std::string /* module */, std::filesystem::path> checkedModules;
+static std::unordered_map<std::string /* file */, CompiledModule> compiledModules;
+static std::mutex modulesMutex;
+
+static std::string toLower(std::string value)
+{
+    std::transform(value.begin(), value.end(), value.begin(), [](unsigned char ch) {
+        return static_cast<char>(std::tolower(ch));
+    });
+    return value;
+}
+
+static bool isSeparator(char ch)
+{
+    return ch == '/' || ch == '\\';
+}
+
+static bool isInsideScriptsFolder(const std::filesystem::path& folder)
+{
+    namespace fs = std::filesystem;
+
+    std::error_code error;
+    const auto scripts{fs::weakly_canonical(scriptsFolder(), error)};
+    if (error) {
+        return false;
+    }
+
+    const auto absolute{fs::weakly_canonical(folder, error)};
+    if (error) {
+        return false;
+    }
+
+    const auto relative{absolute.lexically_relative(scripts)};
+    return !relative.empty() && *relative.begin() != "..";
+}
+
+static ModuleTemplate indexTemplate(const std::string& pattern)
+{
+    namespace fs = std::filesystem;
+
+    const auto start{std::chrono::steady_clock::now()};
+
+    ModuleTemplate moduleTemplate{false, {}};
+
+    const auto mark = pattern.find('?');
+    if (mark == std::string::npos || pattern.find('?', mark + 1) != std::string::npos) {
+        return moduleTemplate;
+    }
+
+    const auto suffix = pattern.substr(mark + 1);
+    if (std::any_of(suffix.begin(), suffix.end(), isSeparator)) {
+        return moduleTemplate;
+    }
+
+    const auto separator = pattern.find_last_of("/\\", mark);
+    const auto prefixStart = separator == std::string::npos ? 0 : separator + 1;
+    const fs::path folder{separator == std::string::npos ? "." : pattern.substr(0, separator)};
+    const auto prefix = pattern.substr(prefixStart, mark - prefixStart);
+    if (!isInsideScriptsFolder(folder)) {
+        return moduleTemplate;
+    }
+
+    moduleTemplate.indexed = true;
+
+    // Module 'a.b' is searched as 'folder/prefix' + 'a/b' + 'suffix', so index subfolders too
+    std::error_code error;
+    fs::recursive_directory_iterator it{folder, fs::directory_options::skip_permission_denied,
+                                        error};
+    const fs::recursive_directory_iterator end{};
+    for (; !error && it != end; it.increment(error)) {
+        if (!it->is_regular_file(error)) {
+            continue;
+        }
+
+        const auto relative = it->path().lexically_relative(folder).generic_string();
+        if (relative.length() <= prefix.length() + suffix.length()
+            || relative.compare(0, prefix.length(), prefix) != 0
+            || relative.compare(relative.length() - suffix.length(), suffix.length(), suffix)
+                   != 0) {
+            continue;
+        }
+
+        auto name = relative.substr(prefix.length(),
+                                    relative.length() - prefix.length() - suffix.length());
+        // Dots in module names are replaced by separators, so such files can not be required
+        if (name.find('.') != std::string::npos) {
+            continue;
+        }
+
+        std::replace(name.begin(), name.end(), '/', '.');
+        moduleTemplate.modules.emplace(toLower(std::move(name)), it->path());
+    }
+
+    const auto elapsed{std::chrono::steady_clock::now() - start};
+    spdlog::debug("Lua module index: {:d} modules in '{:s}', built in {:d} ms",
+                  moduleTemplate.modules.size(), pattern,
+                  std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+    return moduleTemplate;
+}
+
+static const ModuleTemplate& getModuleTemplate(const std::string& pattern)
+{
+    auto it = moduleTemplates.find(pattern);
+    if (it == moduleTemplates.end()) {
+        it = moduleTemplates.emplace(pattern, indexTemplate(pattern)).first;
+    }
+
+    return it->second;
+}
+
+static bool isRegularFile(const std::filesystem::path& file)
+{
+    std::error_code error;
+    return std::filesystem::is_regular_file(file, error);
+}
+
+/** Warns once if later indexed templates have a different file for the same module. */
+static void checkAmbiguousModule(const std::vector<std::string>& patterns,
+                                 std::size_t foundIndex,
+                                 const std::string& key,
+                                 const std::filesystem::path& file)
+{
+    if (!checkedModules.emplace(key, file).second) {
+        return;
+    }
+
+    for (std::size_t i = foundIndex + 1; i < patterns.size(); ++i) {
+        const auto& moduleTemplate = getModuleTemplate(patterns[i]);
+        auto it = moduleTemplate.modules.find(key);
+        if (it == moduleTemplate.modules.end()) {
+            continue;
+        }
+
+        std::error_code error;
+        if (!std::filesystem::equivalent(file, it->second, error)) {
+            spdlog::warn("Lua module '{:s}' is ambiguous: '{:s}' is used, '{:s}' is ignored", key,
+                         file.string(), it->second.string());
+        }
+    }
+}
+
+static bool findModule(const std::string& packagePath,
+                       const std::string& name,
+                       std::filesystem::path& file)
+{
+    std::vector<std::string> patterns;
+    std::size_t begin = 0;
+    while (begin <= packagePath.length()) {
+        auto end = packagePath.find(';', begin);
+        if (end == std::string::npos) {
+            end = packagePath.length();
+        }
+
+        if (end > begin) {
+            patterns.push_back(packagePath.substr(begin, end - begin));
+        }
+
+        begin = end + 1;
+    }
+
+    std::lock_guard<std::mutex> lock(modulesMutex);
+
+    const auto key{toLower(name)};
+    for (std::size_t i = 0; i < patterns.size(); ++i) {
+        const auto& pattern = patterns[i];
+        const auto& moduleTemplate = getModuleTemplate(pattern);
+        if (moduleTemplate.indexed) {
+            auto it = moduleTemplate.modules.find(key);
+            // File could be deleted after the template was indexed, try the next template then
+            if (it != moduleTemplate.modules.end() && isRegularFile(it->second)) {
+                file = it->second;
+                checkAmbiguousModule(patterns, i, key, file);
+                return true;
+            }
+
+            continue;
+        }
+
+        // Same substitution as the standard searcher does
+        std::string fileName{name};
+        std::string::size_type position = 0;
+        while ((position = fileName.find('.', position)) != std::string::npos) {
+            fileName.replace(position, 1, LUA_DIRSEP);
+        }
+
+        std::string candidate{pattern};
+        position = 0;
+        while ((position = candidate.find('?', position)) != std::string::npos) {
+            candidate.replace(position, 1, fileName);
+            position += fileName.length();
+        }
+
+        if (isRegularFile(candidate)) {
+            file = candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static int writeBytecode(lua_State*, const void* data, size_t size, void* userData)
+{
+    static_cast<std::string*>(userData)->append(static_cast<const char*>(data), size);
+    return 0;
+}
+
+/**
+ * Pushes loader of the module file, reuses bytecode compiled by any Lua state.
+ * @returns false if the module could not be loaded, error message is pushed instead.
+ */
+static bool loadModule(lua_State* lua, const std::filesystem::path& file)
+{
+    std::error_code error;
+    const auto writeTime = std::filesystem::last_write_time(file, error);
+    const auto fileName{file.string()};
+    const auto chunkName{"@" + fileName};
+
+    std::shared_ptr<const std::string> bytecode;
+    {
+        std::lock_guard<std::mutex> lock(modulesMutex);
+
+        auto it = compiledModules.find(fileName);
+        if (it != compiledModules.end() && it->second.writeTime == writeTime) {
+            bytecode = it->second.bytecode;
+        }
+    }
+
+    if (bytecode) {
+        return luaL_loadbufferx(lua, bytecode->data(), bytecode->size(), chunkName.c_str(), "b")
+               == LUA_OK;
+    }
+
+    std::ifstream stream{file, std::ios_base::binary};
+    if (!stream) {
+        lua_pushstring(lua, "cannot open file");
+        return false;
+    }
+
+    const std::string source{std::istreambuf_iterator<char>(stream),
+                             std::istreambuf_iterator<char>()};
+    if (luaL_loadbufferx(lua, source.data(), source.size(), chunkName.c_str(), "t") != LUA_OK) {
+        return false;
+    }
+
+    // Keep debug information for error messages and profiler
+    auto compiled = std::make_shared<std::string>();
+    if (lua_dump(lua, writeBytecode, compiled.get(), 0) == 0) {
+        std::lock_guard<std::mutex> lock(modulesMutex);
+        compiledModules[fileName] = {writeTime, std::move(compiled)};
+    }
+
+    return true;
+}
+
+/**
+ * Does the actual search, so all C++ objects are destroyed before moduleSearcher raises
+ * Lua error that does not unwind C++ stack.
+ * @returns number of results pushed or -1 if error message is pushed.
+ */
+static int searchModule(lua_State* lua)
+{
+    const char* name = lua_tostring(lua, 1);
+    if (!name) {
+        lua_pushstring(lua, "module name must be a string");
+        return -1;
+    }
+
+    lua_getglobal(lua, "package");
+    lua_getfield(lua, -1, "path");
+    const char* packagePath = lua_tostring(lua, -1);
+    if (!packagePath) {
+        lua_pushstring(lua, "'package.path' must be a string");
+        return -1;
+    }
+
+    const std::string path{packagePath};
+    lua_pop(lua, 2);
+
+    std::filesystem::path file;
+    if (!findModule(path, name, file)) {
+        lua_pushfstring(lua, "no file for module '%s' in 'package.path'", name);
+        return 1;
+    }
+
+    const auto fileName{file.string()};
+    if (!loadModule(lua, file)) {
+        // Error object is not necessarily a string
+        const char* error = lua_tostring(lua, -1);
+        const std::string reason{error ? error : "(error object is not a string)"};
+        lua_pop(lua, 1);
+        lua_pushfstring(lua, "error loading module '%s' from file '%s':\n\t%s", name,
+                        fileName.c_str(), reason.c_str());
+        return -1;
+    }
+
+    // Standard searcher passes file name to the loader as the second argument
+    lua_pushstring(lua, fileName.c_str());
+    return 2;
+}
+
+static int moduleSearcher(lua_State* lua)
+{
+    const int results = searchModule(lua);
+    if (results < 0) {
+        return lua_error(lua);
+    }
+
+    return results;
+}
+
+void clearModuleIndex()
+{
+    std::lock_guard<std::mutex> lock(modulesMutex);
+    moduleTemplates.clear();
+    checkedModules.clear();
+}
+
+void installModuleSearcher(lua_State* lua)
+{
+    lua_getglobal(lua, "package");
+    if (lua_getfield(lua, -1, "searchers") == LUA_TTABLE) {
+        // Second searcher is the standard one that looks for Lua files using 'package.path'
+        lua_pushcfunction(lua, moduleSearcher);
+        lua_rawseti(lua, -2, 2);
+    }
+
+    lua_pop(lua, 2);
+}
+
+} // namespace hooks
@@ -0,0 +1,287 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "scriptprofiler.h"
+#include "settings.h"
+#include "utils.h"
+#include <algorithm>
+#include <chrono>
+#include <fmt/format.h>
+#include <fstream>
+#include <lua.hpp>
+#include <map>
+#include <mutex>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace hooks {
+
+using ProfilerClock = std::chrono::steady_clock;
+
+static thread_local const char* currentHookName{nullptr};
+
+struct ProfilerFrame
+{
+    /** Collapsed stack including this frame: "hook;script:function;script:function". */
+    std::string stack;
+    /** Function description: "script:function" or "script:line" for anonymous functions. */
+    std::string function;
+    const char* hookName;
+    /** Lua call info of the frame, tail calls reuse call info of the replaced function. */
+    const void* callInfo;
+    ProfilerClock::time_point start;
+    ProfilerClock::duration children;
+    std::uint64_t allocatedOnEnter;
+};
+
+struct ProfilerFunctionStats
+{
+    std::uint64_t calls{};
+    ProfilerClock::duration inclusiveTime{};
+    std::uint64_t allocated{};
+};
+
+using ProfilerFunctionKey = std::pair<std::string /* hook */, std::string /* function */>;
+
+struct ProfilerState
+{
+    /** Guards statistics from writeScriptProfile called by other thread. */
+    std::mutex mutex;
+    lua_Alloc allocator;
+    void* allocatorData;
+    /** Total number of bytes allocated by the state since the profiler was installed. */
+    std::uint64_t allocated;
+    /** Each coroutine has its own call stack. */
+    std::unordered_map<lua_State*, std::vector<ProfilerFrame>> frames;
+    std::map<ProfilerFunctionKey, ProfilerFunctionStats> functions;
+    /** Self time per collapsed stack. */
+    std::unordered_map<std::string, ProfilerClock::duration> stacks;
+};
+
+// Profiler states are intentionally never deleted: Lua states call profilerAllocate
+// until they are closed, which can happen after static destructors of this file are run.
+static std::vector<ProfilerState*> profilerStates;
+static std::mutex profilerStatesMutex;
+
+static void* profilerAllocate(void* userData, void* ptr, size_t oldSize, size_t newSize)
+{
+    auto state = static_cast<ProfilerState*>(userData);
+
+    // When ptr is null, oldSize encodes the type of the object being allocated
+    const size_t currentSize = ptr ? oldSize : 0;
+    if (newSize > currentSize) {
+        state->allocated += newSize - currentSize;
+    }
+
+    return state->allocator(state->allocatorData, ptr, oldSize, newSize);
+}
+
+static ProfilerState* getProfilerState(lua_State* lua)
+{
+    void* userData{};
+    lua_getallocf(lua, &userData);
+    return static_cast<ProfilerState*>(userData);
+}
+
+static std::string getFunctionName(const lua_Debug& info)
+{
+    static const std::string scriptsPrefix{scriptsFolder().string()};
+
+    std::string_view script{info.short_src};
+
+    const std::string_view source{info.source};
+    if (!source.empty() && source.front() == '@') {
+        script = source.substr(1);
+        if (script.compare(0, scriptsPrefix.length(), scriptsPrefix) == 0) {
+            script.remove_prefix(std::min(scriptsPrefix.length() + 1, script.length()));
+        }
+    }
+
+    if (info.name) {
+        return fmt::format("{:s}:{:s}", script, info.name);
+    }
+
+    return fmt::format("{:s}:{:d}", script, info.linedefined);
+}
+
+static void popFrame(ProfilerState& state, std::vector<ProfilerFrame>& frames)
+{
+    const auto elapsed = ProfilerClock::now() - frames.back().start;
+    const auto& frame = frames.back();
+
+    auto& stats = state.functions[{frame.hookName, frame.function}];
+    ++stats.calls;
+    stats.inclusiveTime += elapsed;
+    stats.allocated += state.allocated - frame.allocatedOnEnter;
+
+    state.stacks[frame.stack] += elapsed - frame.children;
+
+    frames.pop_back();
+    if (!frames.empty()) {
+        frames.back().children += elapsed;
+    }
+}
+
+/** Pops the frame with specified call info and all frames above it. */
+static void popFrames(ProfilerState& state,
+                      std::vector<ProfilerFrame>& frames,
+                      const void* callInfo)
+{
+    auto it = std::find_if(frames.begin(), frames.end(),
+                           [callInfo](const ProfilerFrame& frame) {
+                               return frame.callInfo == callInfo;
+                           });
+
+    const auto count = std::distance(it, frames.end());
+    for (auto i = 0; i < count; ++i) {
+        popFrame(state, frames);
+    }
+}
+
+static void profilerHook(lua_State* lua, lua_Debug* info)
+{
+    auto state = getProfilerState(lua);
+    std::lock_guard<std::mutex> lock(state->mutex);
+    auto& frames = state->frames[lua];
+
+    if (info->event == LUA_HOOKRET) {
+        popFrames(*state, frames, info->i_ci);
+        if (frames.empty()) {
+            // Finished coroutines are never resumed again
+            state->frames.erase(lua);
+        }
+
+        return;
+    }
+
+    if (info->event != LUA_HOOKCALL && info->event != LUA_HOOKTAILCALL) {
+        return;
+    }
+
+    if (info->event == LUA_HOOKCALL) {
+        // Lua errors unwind the stack without return events.
+        // Frames that reuse call info of a new call are the ones left after such unwinding.
+        popFrames(*state, frames, info->i_ci);
+    }
+
+    lua_getinfo(lua, "Sn", info);
+
+    ProfilerFrame frame;
+    frame.function = getFunctionName(*info);
+    if (frames.empty()) {
+        frame.hookName = currentHookName ? currentHookName : "unknown";
+        frame.stack = fmt::format("{:s};{:s}", frame.hookName, frame.function);
+    } else {
+        frame.hookName = frames.back().hookName;
+        frame.stack = fmt::format("{:s};{:s}", frames.back().stack, frame.function);
+    }
+
+    frame.callInfo = info->i_ci;
+    frame.children = ProfilerClock::duration::zero();
+    frame.allocatedOnEnter = state->allocated;
+    // Take time last so profiler bookkeeping is not attributed to the function
+    frame.start = ProfilerClock::now();
+    frames.push_back(std::move(frame));
+}
+
+void installScriptProfiler(lua_State* lua)
+{
+    if (!gameSettings().debug.profileScripts) {
+        return;
+    }
+
+    auto state = new ProfilerState{};
+    state->allocator = lua_getallocf(lua, &state->allocatorData);
+    lua_setallocf(lua, profilerAllocate, state);
+    lua_sethook(lua, profilerHook, LUA_MASKCALL | LUA_MASKRET, 0);
+
+    std::lock_guard<std::mutex> lock(profilerStatesMutex);
+    profilerStates.push_back(state);
+}
+
+void writeScriptProfile()
+{
+    using namespace std::chrono;
+
+    std::lock_guard<std::mutex> lock(profilerStatesMutex);
+    if (profilerStates.empty()) {
+        return;
+    }
+
+    std::map<ProfilerFunctionKey, ProfilerFunctionStats> functions;
+    std::map<std::string, ProfilerClock::duration> stacks;
+    for (const auto state : profilerStates) {
+        std::lock_guard<std::mutex> stateLock(state->mutex);
+
+        for (const auto& [key, stats] : state->functions) {
+            auto& total = functions[key];
+            total.calls += stats.calls;
+            total.inclusiveTime += stats.inclusiveTime;
+            total.allocated += stats.allocated;
+        }
+
+        for (const auto& [stack, selfTime] : state->stacks) {
+            stacks[stack] += selfTime;
+        }
+    }
+
+    std::vector<std::pair<ProfilerFunctionKey, ProfilerFunctionStats>> sorted{functions.begin(),
+                                                                             functions.end()};
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+        return a.second.inclusiveTime > b.second.inclusiveTime;
+    });
+
+    const auto summaryPath{gameFolder() / "luaProfile.txt"};
+    std::ofstream summary{summaryPath};
+    summary << fmt::format("{:>12s} {:>14s} {:>14s}  {:s}\n", "calls", "inclusive (us)",
+                           "allocated (B)", "hook / function");
+    for (const auto& [key, stats] : sorted) {
+        summary << fmt::format("{:>12d} {:>14d} {:>14d}  {:s} / {:s}\n", stats.calls,
+                               duration_cast<microseconds>(stats.inclusiveTime).count(),
+                               stats.allocated, key.first, key.second);
+    }
+
+    const auto foldedPath{gameFolder() / "luaProfile.folded"};
+    std::ofstream folded{foldedPath};
+    for (const auto& [stack, selfTime] : stacks) {
+        const auto value = duration_cast<microseconds>(selfTime).count();
+        if (value > 0) {
+            folded << fmt::format("{:s} {:d}\n", stack, value);
+        }
+    }
+
+    spdlog::debug("Lua profile is written to '{:s}' and '{:s}'", summaryPath.string(),
+                 foldedPath.string());
+}
+
+ScriptProfilerScope::ScriptProfilerScope(const char* hookName)
+    : m_prevHookName(currentHookName)
+{
+    currentHookName = hookName;
+}
+
+ScriptProfilerScope::~ScriptProfilerScope()
+{
+    currentHookName = m_prevHookName;
+}
+
+} // namespace hooks
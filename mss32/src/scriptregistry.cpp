@@ -0,0 +1,146 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "scriptregistry.h"
+#include "scriptmodules.h"
+#include "scripts.h"
+#include "settings.h"
+#include <spdlog/spdlog.h>
+#include <thread>
+
+extern std::thread::id mainThreadId;
+
+namespace hooks {
+
+// Hooks ask for functions very often, do not touch the file system on every call
+static constexpr std::chrono::seconds pollInterval{1};
+
+static std::filesystem::file_time_type getWriteTime(const std::filesystem::path& path)
+{
+    std::error_code error;
+    const auto writeTime = std::filesystem::last_write_time(path, error);
+    return error ? std::filesystem::file_time_type::min() : writeTime;
+}
+
+static long long getElapsedMs(std::chrono::steady_clock::time_point start)
+{
+    using namespace std::chrono;
+
+    return duration_cast<milliseconds>(steady_clock::now() - start).count();
+}
+
+ScriptFunction ScriptRegistry::getFunction(const std::filesystem::path& path,
+                                           const char* name,
+                                           bool bindScenario)
+{
+    if (gameSettings().debug.reloadScripts) {
+        reloadChangedScripts();
+    }
+
+    auto it = m_scripts.find(path);
+    if (it == m_scripts.end()) {
+        it = m_scripts.emplace(path, Script{}).first;
+        it->second.bindScenario = bindScenario;
+        loadScript(path, it->second);
+    }
+
+    auto& script = it->second;
+    if (!script.environment) {
+        return {};
+    }
+
+    auto function = script.functions.find(name);
+    if (function == script.functions.end()) {
+        function = script.functions.emplace(name, getScriptFunction(*script.environment, name))
+                       .first;
+    }
+
+    return {script.environment, function->second};
+}
+
+void ScriptRegistry::reloadChangedScripts()
+{
+    const auto now{std::chrono::steady_clock::now()};
+    if (now - m_lastPoll < pollInterval) {
+        return;
+    }
+
+    m_lastPoll = now;
+
+    for (auto& [path, script] : m_scripts) {
+        if (getWriteTime(path) != script.writeTime) {
+            // Changed script could require modules that did not exist when they were indexed
+            clearModuleIndex();
+            reloadScript(path, script);
+        }
+    }
+}
+
+void ScriptRegistry::loadScript(const std::filesystem::path& path, Script& script)
+{
+    const auto start{std::chrono::steady_clock::now()};
+
+    script.writeTime = getWriteTime(path);
+    script.environment = executeScriptFile(path, false, script.bindScenario);
+
+    if (script.environment) {
+        spdlog::debug("Script '{:s}' loaded in {:d} ms", path.filename().string(),
+                      getElapsedMs(start));
+    }
+}
+
+bool ScriptRegistry::reloadScript(const std::filesystem::path& path, Script& script)
+{
+    const auto start{std::chrono::steady_clock::now()};
+
+    // Remember write time even if reload fails, so broken script is not executed repeatedly
+    script.writeTime = getWriteTime(path);
+
+    std::string error;
+    auto environment = reloadScriptFile(path, script.bindScenario, error);
+    if (!environment) {
+        spdlog::error("Could not reload script '{:s}', previous version is used. Reason: {:s}",
+                      path.string(), error);
+        return false;
+    }
+
+    // Replace all handles at once, so callers never get functions from different versions.
+    // Old environment is collected by Lua when the last function that uses it is released.
+    std::map<std::string, std::optional<sol::function>> functions;
+    for (const auto& entry : script.functions) {
+        functions.emplace(entry.first, getScriptFunction(*environment, entry.first.c_str()));
+    }
+
+    script.environment = std::move(environment);
+    script.functions = std::move(functions);
+
+    spdlog::info("Script '{:s}' reloaded in {:d} ms", path.filename().string(),
+                 getElapsedMs(start));
+    return true;
+}
+
+ScriptRegistry& getScriptRegistry()
+{
+    static ScriptRegistry mainThreadRegistry;
+    static ScriptRegistry workerThreadRegistry;
+
+    return std::this_thread::get_id() == mainThreadId ? mainThreadRegistry : workerThreadRegistry;
+}
+
+} // namespace hooks
@@ -45,6 +45,7 @@
 #include "itemview.h"
 #include "landmarkview.h"
 #include "locationview.h"
+#include "luaallocator.h"
 #include "magetowerview.h"
 #include "merchantview.h"
 #include "mercsview.h"
@@ -52,12 +53,16 @@
 #include "modifierview.h"
 #include "playerview.h"
 #include "point.h"
+#include "randomstream.h"
 #include "resourcemarketview.h"
 #include "rodview.h"
 #include "ruinview.h"
 #include "scenariovariableview.h"
 #include "scenarioview.h"
 #include "scenvariablesview.h"
+#include "scriptlog.h"
+#include "scriptmodules.h"
+#include "scriptprofiler.h"
 #include "settings.h"
 #include "siteview.h"
 #include "stackview.h"
@@ -69,6 +74,8 @@
 #include "unitview.h"
 #include "unitviewdummy.h"
 #include "utils.h"
+#include <algorithm>
+#include <cctype>
 #include <mutex>
 #include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/spdlog.h>
@@ -81,6 +88,9 @@ namespace hooks {
 
 // Global static variables ensure that it will be destroyed after local static variables that depend
 // on Lua (such as CustomUnitEncyclopedia).
+// Allocators are declared first so they are destroyed after the states that use them.
+static std::unique_ptr<LuaAllocator> mainThreadLuaAllocator;
+static std::unique_ptr<LuaAllocator> workerThreadLuaAllocator;
 static std::unique_ptr<sol::state> mainThreadLua;
 static std::unique_ptr<sol::state> workerThreadLua;
 static std::string serverLogName = "server";
@@ -94,18 +104,6 @@ struct PathHash
     }
 };
 
-static void logClient(const std::string& message)
-{
-    // TODO: provide different log levels for scripts
-    spdlog::get(clientLogName)->debug(message);
-}
-
-static void logServer(const std::string& message)
-{
-    // TODO: provide different log levels for scripts
-    spdlog::get(serverLogName)->debug(message);
-}
-
 static std::shared_ptr<spdlog::logger> createLogger(bool client)
 {
     auto logger = spdlog::get(client ? clientLogName : serverLogName);
@@ -120,14 +118,14 @@ static std::shared_ptr<spdlog::logger> createLogger(bool client)
         return logger;
     }
 
-    // TODO: rename to mss32Scripting.log when different log levels are available
-    auto fileName = hooks::gameFolder() / "luaDebug.log";
+    // Synchronous, so messages written before a crash are kept.
+    // Amount of messages is limited by 'log' functions instead
+    auto fileName = hooks::gameFolder() / "mss32Scripting.log";
     auto newLogger = spdlog::rotating_logger_mt(client ? clientLogName : serverLogName,
                                                 fileName.string(), 5u << 20, 3);
-    // TODO: setting for all available trace levels (not only debug vs non-debug)
-    // TODO: add log level to the pattern when different log levels are available
-    newLogger->set_level(gameSettings().debugMode ? spdlog::level::trace : spdlog::level::info);
-    newLogger->set_pattern("%D %H:%M:%S.%e [%=8!n] %v", spdlog::pattern_time_type::utc);
+    // Levels are filtered by 'log' functions, see bindScriptLog
+    newLogger->set_level(spdlog::level::trace);
+    newLogger->set_pattern("%D %H:%M:%S.%e [%=8!n] [%L] %v", spdlog::pattern_time_type::utc);
     return newLogger;
 }
 
@@ -525,17 +523,13 @@ static void bindApi(sol::state& lua)
     bindings::BuildingView::bind(lua);
     bindings::AttackView::bind(lua);
 
-    if (std::this_thread::get_id() == mainThreadId) {
-        createLogger(true);
-        lua.set_function("log", logClient);
-    } else {
-        createLogger(false);
-        lua.set_function("log", logServer);
-    }
+    bindScriptLog(lua, createLogger(std::this_thread::get_id() == mainThreadId));
 
     lua.set_function("randomNumber", [](std::uint32_t maxValue) {
         return game::gameFunctions().generateRandomNumber(maxValue);
     });
+
+    bindRandomStreams(lua);
 }
 
 // https://sol2.readthedocs.io/en/latest/threading.html
@@ -543,30 +537,49 @@ static void bindApi(sol::state& lua)
 // Treat access and object handling like you were dealing with a raw int reference (int&).
 sol::state& getLua()
 {
-    auto& lua = std::this_thread::get_id() == mainThreadId ? mainThreadLua : workerThreadLua;
+    const bool mainThread = std::this_thread::get_id() == mainThreadId;
+    auto& lua = mainThread ? mainThreadLua : workerThreadLua;
     if (lua == nullptr) {
-        lua = std::make_unique<sol::state>();
+        auto& allocator = mainThread ? mainThreadLuaAllocator : workerThreadLuaAllocator;
+        allocator = std::make_unique<LuaAllocator>(mainThread ? clientLogName.c_str()
+                                                              : serverLogName.c_str());
+
+        lua = std::make_unique<sol::state>(sol::default_at_panic, &LuaAllocator::allocate,
+                                           allocator.get());
         lua->open_libraries(sol::lib::base, sol::lib::package, sol::lib::math, sol::lib::table,
                             sol::lib::os, sol::lib::string, sol::lib::debug);
+        installModuleSearcher(lua->lua_state());
         bindApi(*lua);
+
+        // Settings are read using Lua, so the limit can only be applied after the state is created
+        allocator->setMemoryLimit(std::size_t{gameSettings().engine.scriptMemoryLimit} << 20);
+        installScriptProfiler(lua->lua_state());
     }
 
     return *lua;
 }
 
-const std::string& getSource(const std::filesystem::path& path)
+/**
+ * Returns cached script source, reads the file on first access or when reload is requested.
+ * Sources are shared, so reloading a file does not invalidate sources that are still in use.
+ */
+std::shared_ptr<const std::string> getSource(const std::filesystem::path& path,
+                                             bool reload = false)
 {
-    static std::unordered_map<std::filesystem::path, std::string, PathHash> sources;
+    static std::unordered_map<std::filesystem::path, std::shared_ptr<const std::string>, PathHash>
+        sources;
     static std::mutex sourcesMutex;
 
     const std::lock_guard<std::mutex> lock(sourcesMutex);
 
-    auto it = sources.find(path);
-    if (it != sources.end())
-        return it->second;
+    if (!reload) {
+        auto it = sources.find(path);
+        if (it != sources.end())
+            return it->second;
+    }
 
-    auto& source = sources[path];
-    source = readFile(path);
+    auto source = std::make_shared<const std::string>(readFile(path));
+    sources[path] = source;
     return source;
 }
 
@@ -637,15 +650,15 @@ std::optional<sol::environment> executeUserSettingsFile(const std::filesystem::p
     if (!alwaysExists && !std::filesystem::exists(path))
         return std::nullopt;
 
-    const auto& source = getSource(path);
-    if (source.empty()) {
+    const auto source = getSource(path);
+    if (source->empty()) {
         showErrorMessageBox(fmt::format("Failed to read '{:s}' script file.", path.string()));
         return std::nullopt;
     }
 
     sol::protected_function_result result;
 
-    auto env = executeUserSettingsScript(source, result);
+    auto env = executeUserSettingsScript(*source, result);
 
     if (!result.valid()) {
         const sol::error err = result;
@@ -658,17 +671,46 @@ std::optional<sol::environment> executeUserSettingsFile(const std::filesystem::p
     return {std::move(env)};
 }
 
-sol::environment executeScript(const std::string& source,
-                               sol::protected_function_result& result,
-                               bool bindScenario)
+/**
+ * Script files use streams named by their lowercase paths relative to the scripts folder,
+ * so the names are the same on all machines. Scripts from scenario share a single stream.
+ */
+static std::string getRandomStreamName(const std::string& chunkName)
+{
+    if (chunkName.empty() || chunkName[0] != '@') {
+        return "script";
+    }
+
+    const std::filesystem::path path{chunkName.substr(1)};
+    auto name{path.lexically_relative(scriptsFolder()).generic_string()};
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char ch) {
+        return static_cast<char>(std::tolower(ch));
+    });
+
+    return name;
+}
+
+static sol::environment executeScript(const std::string& source,
+                                      const std::string& chunkName,
+                                      sol::protected_function_result& result,
+                                      bool bindScenario)
 {
     auto& lua = getLua();
 
     // Environment prevents cluttering of global namespace by scripts
     // making each script run isolated from others.
     sol::environment env{lua, sol::create, lua.globals()};
-    result = lua.safe_script(source, env,
-                             [](lua_State*, sol::protected_function_result pfr) { return pfr; });
+    // Script with its own log level shadows global 'log' table
+    auto log = createScriptLog(lua, chunkName);
+    if (log.valid()) {
+        env["log"] = log;
+    }
+
+    env["rng"] = &getRandomStream(getRandomStreamName(chunkName));
+
+    result = lua.safe_script(
+        source, env, [](lua_State*, sol::protected_function_result pfr) { return pfr; },
+        chunkName);
 
     env["getGlobal"] = &getGlobal;
     env["getGame"] = &getGame;
@@ -681,6 +723,13 @@ sol::environment executeScript(const std::string& source,
     return env;
 }
 
+sol::environment executeScript(const std::string& source,
+                               sol::protected_function_result& result,
+                               bool bindScenario)
+{
+    return executeScript(source, sol::detail::default_chunk_name(), result, bindScenario);
+}
+
 std::optional<sol::environment> executeScriptFile(const std::filesystem::path& path,
                                                   bool alwaysExists,
                                                   bool bindScenario)
@@ -688,14 +737,15 @@ std::optional<sol::environment> executeScriptFile(const std::filesystem::path& p
     if (!alwaysExists && !std::filesystem::exists(path))
         return std::nullopt;
 
-    const auto& source = getSource(path);
-    if (source.empty()) {
+    const auto source = getSource(path);
+    if (source->empty()) {
         showErrorMessageBox(fmt::format("Failed to read '{:s}' script file.", path.string()));
         return std::nullopt;
     }
 
     sol::protected_function_result result;
-    auto env = executeScript(source, result, bindScenario);
+    // '@' prefix makes Lua treat chunk name as a file name in error messages and debug info
+    auto env = executeScript(*source, "@" + path.string(), result, bindScenario);
     if (!result.valid()) {
         const sol::error err = result;
         showErrorMessageBox(fmt::format("Failed to execute script '{:s}'.\n"
@@ -707,6 +757,27 @@ std::optional<sol::environment> executeScriptFile(const std::filesystem::path& p
     return {std::move(env)};
 }
 
+std::optional<sol::environment> reloadScriptFile(const std::filesystem::path& path,
+                                                 bool bindScenario,
+                                                 std::string& error)
+{
+    const auto source = getSource(path, true);
+    if (source->empty()) {
+        error = "Failed to read script file";
+        return std::nullopt;
+    }
+
+    sol::protected_function_result result;
+    auto env = executeScript(*source, "@" + path.string(), result, bindScenario);
+    if (!result.valid()) {
+        const sol::error err = result;
+        error = err.what();
+        return std::nullopt;
+    }
+
+    return {std::move(env)};
+}
+
 std::optional<sol::function> getScriptFunction(const sol::environment& environment,
                                                const char* name,
                                                bool alwaysExists)
@@ -168,6 +168,24 @@ static void readDebugSettings(const sol::table& table, Settings::Debug& value)
                                                    def.sendObjectsChangesTreshold);
     value.logSinglePlayerMessages = readSetting(category.value(), "logSinglePlayerMessages",
                                                 def.logSinglePlayerMessages);
+    value.profileScripts = readSetting(category.value(), "profileScripts", def.profileScripts);
+    value.reloadScripts = readSetting(category.value(), "reloadScripts", def.reloadScripts);
+    value.scriptLogLevel = readSetting(category.value(), "scriptLogLevel", def.scriptLogLevel);
+    value.scriptLogRateLimit = readSetting(category.value(), "scriptLogRateLimit",
+                                           def.scriptLogRateLimit);
+    value.dumpScenarioOnSave = readSetting(category.value(), "dumpScenarioOnSave",
+                                           def.dumpScenarioOnSave);
+    value.recordBattleAi = readSetting(category.value(), "recordBattleAi", def.recordBattleAi);
+
+    value.scriptLogLevels.clear();
+    auto levels = category.value().get<sol::optional<sol::table>>("scriptLogLevels");
+    if (levels.has_value()) {
+        for (const auto& [path, level] : levels.value()) {
+            if (path.is<std::string>() && level.is<std::string>()) {
+                value.scriptLogLevels[path.as<std::string>()] = level.as<std::string>();
+            }
+        }
+    }
 }
 
 static void readEngineSettings(const sol::table& table, Settings::Engine& value)
@@ -183,6 +201,9 @@ static void readEngineSettings(const sol::table& table, Settings::Engine& value)
     value.sendRefreshInfoObjectCountLimit = readSetting(category.value(),
                                                         "sendRefreshInfoObjectCountLimit",
                                                         def.sendRefreshInfoObjectCountLimit);
+    // Limit is in megabytes, keep it below 4 GB so it fits into size_t in bytes
+    value.scriptMemoryLimit = readSetting(category.value(), "scriptMemoryLimit",
+                                          def.scriptMemoryLimit, 0u, 4095u);
 }
 
 static void readBattleSettings(const sol::table& table, Settings::Battle& value)
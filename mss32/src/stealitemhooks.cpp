@@ -42,6 +42,7 @@
 #include "midsitemerchant.h"
 #include "phasegame.h"
 #include "playerview.h"
+#include "scriptregistry.h"
 #include "scripts.h"
 #include "task.h"
 #include "utils.h"
@@ -56,14 +57,6 @@ namespace hooks {
 
 thread_local StealItemBuildContext g_stealItemCtx;
 
-//
-// lua
-//
-
-static std::optional<sol::environment> env;
-
-static std::optional<sol::function> theftFilterItemsMerchantLua;
-
 static int getItemTotalCost(const game::StealItemEntry* item)
 {
     if (!item) {
@@ -157,22 +150,10 @@ bool shouldDisplayStealItem(game::StealItemEntry* entry)
     // lua load
     //
 
-    if (!theftFilterItemsMerchantLua) {
-
-        const auto path{scriptsFolder() / "theft.lua"};
-
-        theftFilterItemsMerchantLua = getScriptFunction(path, "theftFilterItemsMerchant", env,
-                                                        false, true);
-
-        if (theftFilterItemsMerchantLua) {
-
-            spdlog::info("[STEAL_ITEM] lua loaded");
-
-        } else {
-
-            spdlog::info("[STEAL_ITEM] lua missing");
-        }
-    }
+    const auto theftFilterItemsMerchantLua{
+        getScriptRegistry()
+            .getFunction(scriptsFolder() / "theft.lua", "theftFilterItemsMerchant")
+            .function};
 
     if (!g_stealItemCtx.objectMap) {
         return false;
@@ -0,0 +1,215 @@
+/*
+ * This file is part of the modding toolset for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2ModdingToolset)
+ * Copyright (C) 2026 Rapthos.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "taskgraph.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+#include <thread>
+
+namespace hooks {
+
+static const char* getTaskStatusDesc(TaskGraph::TaskStatus status)
+{
+    switch (status) {
+    case TaskGraph::TaskStatus::Pending:
+        return "pending";
+    case TaskGraph::TaskStatus::Succeeded:
+        return "succeeded";
+    case TaskGraph::TaskStatus::Failed:
+        return "failed";
+    case TaskGraph::TaskStatus::Skipped:
+        return "skipped";
+    default:
+        return "unknown";
+    }
+}
+
+TaskGraph::TaskId TaskGraph::addTask(std::string name,
+                                     Task task,
+                                     const std::vector<TaskId>& dependencies,
+                                     bool callingThread)
+{
+    const TaskId id{m_tasks.size()};
+
+    for (auto dependency : dependencies) {
+        // Tasks can only depend on already added ones, this makes cycles impossible
+        if (dependency >= id) {
+            throw std::invalid_argument("Task dependency is not added to the graph yet");
+        }
+
+        m_tasks[dependency].dependents.push_back(id);
+    }
+
+    m_tasks.push_back({std::move(task), {}, dependencies.size(), false, callingThread});
+    m_results.push_back({std::move(name), TaskStatus::Pending, {}, {}});
+    return id;
+}
+
+bool TaskGraph::run(unsigned int threadCount)
+{
+    if (!threadCount) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    const auto runStart{std::chrono::steady_clock::now()};
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<TaskId> readyTasks;
+    std::deque<TaskId> readyCallingThreadTasks;
+    std::size_t remaining{m_tasks.size()};
+
+    auto enqueue = [&](TaskId id) {
+        if (m_tasks[id].callingThread) {
+            readyCallingThreadTasks.push_back(id);
+        } else {
+            readyTasks.push_back(id);
+        }
+    };
+
+    for (TaskId id = 0; id < m_tasks.size(); ++id) {
+        if (!m_tasks[id].pendingDependencies) {
+            enqueue(id);
+        }
+    }
+
+    auto execute = [&](TaskId id) {
+        const auto& info = m_tasks[id];
+        auto& result = m_results[id];
+
+        if (info.dependencyFailed) {
+            result.status = TaskStatus::Skipped;
+        } else {
+            const auto start{std::chrono::steady_clock::now()};
+            try {
+                result.status = info.task() ? TaskStatus::Succeeded : TaskStatus::Failed;
+            } catch (const std::exception& e) {
+                result.status = TaskStatus::Failed;
+                result.error = e.what();
+            }
+            result.duration = std::chrono::steady_clock::now() - start;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto dependentId : info.dependents) {
+            auto& dependent = m_tasks[dependentId];
+            if (result.status != TaskStatus::Succeeded) {
+                dependent.dependencyFailed = true;
+            }
+
+            if (--dependent.pendingDependencies == 0) {
+                enqueue(dependentId);
+            }
+        }
+
+        --remaining;
+        condition.notify_all();
+    };
+
+    auto workerLoop = [&]() {
+        while (true) {
+            TaskId id;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&]() { return !readyTasks.empty() || remaining == 0; });
+                if (readyTasks.empty()) {
+                    return;
+                }
+
+                id = readyTasks.front();
+                readyTasks.pop_front();
+            }
+
+            execute(id);
+        }
+    };
+
+    const auto workerTasksTotal = std::count_if(m_tasks.begin(), m_tasks.end(),
+                                                [](const TaskInfo& info) {
+                                                    return !info.callingThread;
+                                                });
+    const auto workersTotal = std::min<std::size_t>(threadCount - 1, workerTasksTotal);
+
+    std::vector<std::thread> workers;
+    workers.reserve(workersTotal);
+    for (std::size_t i = 0; i < workersTotal; ++i) {
+        workers.emplace_back(workerLoop);
+    }
+
+    // Calling thread executes its own tasks and helps workers with the rest
+    while (true) {
+        TaskId id;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [&]() {
+                return !readyCallingThreadTasks.empty() || !readyTasks.empty() || remaining == 0;
+            });
+
+            if (!readyCallingThreadTasks.empty()) {
+                id = readyCallingThreadTasks.front();
+                readyCallingThreadTasks.pop_front();
+            } else if (!readyTasks.empty()) {
+                id = readyTasks.front();
+                readyTasks.pop_front();
+            } else {
+                break;
+            }
+        }
+
+        execute(id);
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    m_runDuration = std::chrono::steady_clock::now() - runStart;
+
+    return std::all_of(m_results.begin(), m_results.end(), [](const TaskResult& result) {
+        return result.status == TaskStatus::Succeeded;
+    });
+}
+
+const std::vector<TaskGraph::TaskResult>& TaskGraph::getResults() const
+{
+    return m_results;
+}
+
+void TaskGraph::logTimings(const char* graphName) const
+{
+    using namespace std::chrono;
+
+    steady_clock::duration total{};
+    for (const auto& result : m_results) {
+        total += result.duration;
+        spdlog::debug("{:s}: task '{:s}' {:s} in {:d} ms", graphName, result.name,
+                      getTaskStatusDesc(result.status),
+                      duration_cast<milliseconds>(result.duration).count());
+    }
+
+    spdlog::info("{:s}: {:d} tasks finished in {:d} ms, {:d} ms of total work", graphName,
+                 m_results.size(), duration_cast<milliseconds>(m_runDuration).count(),
+                 duration_cast<milliseconds>(total).count());
+}
+
+} // namespace hooks
@@ -10,6 +10,7 @@
 #include "midplayer.h"
 #include "phasegame.h"
 #include "playerview.h"
+#include "scriptprofiler.h"
 #include "scripts.h"
 #include "midserverlogic.h"
 
@@ -34,6 +35,9 @@ void __fastcall beginTurnHooked(game::CMidServerLogicData* thisptr,
 
     beginTurnOrig(thisptr, playerId);
 
+    // Profile is rewritten each turn, so it is available after exit or crash
+    writeScriptProfile();
+
     if (!thisptr || !playerId) {
         return;
     }
@@ -26,6 +26,7 @@
 #include "phasegame.h"
 #include "playerbuildings.h"
 #include "racetype.h"
+#include "scriptregistry.h"
 #include "scripts.h"
 #include "unitsforhire.h"
 #include "usracialsoldier.h"
@@ -256,13 +257,10 @@ bool __stdcall addPlayerUnitsToHireListHooked(game::CMidDataCache2* dataCache,
         }
     }
 
-    static std::optional<sol::environment> env;
-    static std::optional<sol::function> processFunction;
-    const std::filesystem::path path = scriptsFolder() / "hire.lua";
-
-    if (!env && !processFunction) {
-        processFunction = getScriptFunction(path, "getUnitsHireList", env, false, true);
-    }
+    const auto script{getScriptRegistry().getFunction(scriptsFolder() / "hire.lua",
+                                                     "getUnitsHireList")};
+    const auto& env{script.environment};
+    const auto& processFunction{script.function};
 
     if (processFunction) {
         try {
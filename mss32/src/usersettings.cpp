@@ -300,6 +300,9 @@ static void readLobbySettings(const sol::table& table, Lobby& value)
     value.server.ip = def.server.ip;
     value.server.port = def.server.port;
     value.client.port = def.client.port;
+    value.faults = def.faults;
+    value.pushUpdates = def.pushUpdates;
+    value.captureTraffic = def.captureTraffic;
 
     auto lobby = table.get<sol::optional<sol::table>>("lobby");
     if (!lobby.has_value())
@@ -318,6 +321,23 @@ static void readLobbySettings(const sol::table& table, Lobby& value)
     if (client.has_value()) {
         value.client.port = readSetting(client.value(), "port", def.client.port);
     }
+
+    value.pushUpdates = readSetting(lobby.value(), "pushUpdates", def.pushUpdates);
+    value.captureTraffic = readSetting(lobby.value(), "captureTraffic", def.captureTraffic);
+
+    auto faults = lobby.value().get<sol::optional<sol::table>>("faults");
+
+    if (faults.has_value()) {
+        const auto& defFaults = def.faults;
+
+        value.faults.delay = readSetting(faults.value(), "delay", defFaults.delay, 0u, 10000u);
+        value.faults.jitter = readSetting(faults.value(), "jitter", defFaults.jitter, 0u, 10000u);
+        value.faults.lossChance = readSetting(faults.value(), "lossChance", defFaults.lossChance,
+                                              0u, 100u);
+        value.faults.disconnectChance = readSetting(faults.value(), "disconnectChance",
+                                                    defFaults.disconnectChance, 0u, 10000u);
+        value.faults.seed = readSetting(faults.value(), "seed", defFaults.seed);
+    }
 }
 static void readUserSettings(const sol::table& table, UserSettings& settings)
 {
@@ -29,9 +29,13 @@
 #include "smartptr.h"
 #include "sounds.h"
 #include "uimanager.h"
+#include <chrono>
+#include <ctime>
 #include <fstream>
+#include <mutex>
 #include <random>
 #include <spdlog/spdlog.h>
+#include <unordered_map>
 #include <wincrypt.h>
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
@@ -365,7 +369,39 @@ std::uint32_t createMessageEvent(game::UiEvent* messageEvent,
     return messageId;
 }
 
-std::string computeHash(std::vector<std::filesystem::path> filenames)
+// Hashes of file lists keyed by their stamps.
+// Kept for the game session only, hashes are never read from files that users can edit
+static std::unordered_map<std::string /* stamp */, std::string /* hash */> fileHashes;
+static std::mutex fileHashesMutex;
+static constexpr std::size_t fileHashesMaxCount{256};
+
+/**
+ * Describes sorted files by their paths, sizes and write times,
+ * so changed files are detected without reading them.
+ */
+static bool getFilesStamp(const std::vector<std::filesystem::path>& filenames, std::string& stamp)
+{
+    for (const auto& file : filenames) {
+        std::error_code error;
+        const auto size = std::filesystem::file_size(file, error);
+        if (error) {
+            return false;
+        }
+
+        const auto writeTime = std::filesystem::last_write_time(file, error);
+        if (error) {
+            return false;
+        }
+
+        // '|' is not allowed in file names on Windows
+        stamp += fmt::format("{:s}|{:d}|{:d}|", file.string(), size,
+                             writeTime.time_since_epoch().count());
+    }
+
+    return true;
+}
+
+static std::string hashFiles(const std::vector<std::filesystem::path>& filenames)
 {
     struct HashGuard
     {
@@ -380,8 +416,6 @@ std::string computeHash(std::vector<std::filesystem::path> filenames)
         HCRYPTHASH hash{};
     };
 
-    std::sort(filenames.begin(), filenames.end());
-
     HashGuard guard;
     if (!CryptAcquireContext(&guard.provider, nullptr, nullptr, PROV_RSA_FULL,
                              CRYPT_VERIFYCONTEXT)) {
@@ -431,6 +465,36 @@ std::string computeHash(std::vector<std::filesystem::path> filenames)
     return hash;
 }
 
+std::string computeHash(std::vector<std::filesystem::path> filenames)
+{
+    std::sort(filenames.begin(), filenames.end());
+
+    std::string stamp;
+    if (!getFilesStamp(filenames, stamp)) {
+        return hashFiles(filenames);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(fileHashesMutex);
+        auto it = fileHashes.find(stamp);
+        if (it != fileHashes.end()) {
+            return it->second;
+        }
+    }
+
+    auto hash = hashFiles(filenames);
+    if (!hash.empty()) {
+        std::lock_guard<std::mutex> lock(fileHashesMutex);
+        if (fileHashes.size() >= fileHashesMaxCount) {
+            fileHashes.clear();
+        }
+
+        fileHashes[stamp] = hash;
+    }
+
+    return hash;
+}
+
 void forEachScenarioObject(const game::IMidgardObjectMap* objectMap,
                            game::IdType idType,
                            const std::function<void(const game::IMidScenarioObject*)>& func)
@@ -540,4 +604,47 @@ void playSoundEffect(game::SoundEffect effect)
     api.soundsPtrSetData(&sounds, nullptr);
 }
 
+std::filesystem::path createTimestampedFile(std::ofstream& stream,
+                                            const std::filesystem::path& folder,
+                                            const char* prefix,
+                                            const char* extension,
+                                            bool binary)
+{
+    using namespace std::chrono;
+
+    // Existence check and creation must not interleave between threads
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::error_code error;
+    std::filesystem::create_directories(folder, error);
+
+    const auto now{system_clock::now()};
+    const auto time{system_clock::to_time_t(now)};
+    const auto milliseconds = duration_cast<std::chrono::milliseconds>(now.time_since_epoch())
+                                  .count()
+                              % 1000;
+
+    std::tm localTime{};
+    localtime_s(&localTime, &time);
+
+    char timestamp[32];
+    std::strftime(timestamp, sizeof(timestamp), "%Y%m%d-%H%M%S", &localTime);
+
+    const auto name{fmt::format("{:s}-{:s}-{:03d}", prefix, timestamp, milliseconds)};
+
+    auto path{folder / fmt::format("{:s}.{:s}", name, extension)};
+    for (int counter = 1; std::filesystem::exists(path, error); ++counter) {
+        path = folder / fmt::format("{:s}-{:d}.{:s}", name, counter, extension);
+    }
+
+    auto mode{std::ios_base::out | std::ios_base::trunc};
+    if (binary) {
+        mode |= std::ios_base::binary;
+    }
+
+    stream.open(path, mode);
+    return path;
+}
+
 } // namespace hooks